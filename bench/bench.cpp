@@ -0,0 +1,609 @@
+// Benchmarks of the hot paths against the same work on raw reps. Every units
+// benchmark of work a raw rep can do has a Raw twin: on a release build the
+// two should match, and a gap between them is a regression of the zero
+// overhead promise. Benchmarks of work raw reps have no counterpart for,
+// such as packing or sorting by unit, compare two ways of doing it instead.
+//
+// Run with --benchmark_format=json (or the units_bench_json target) to get
+// output that can be diffed between releases.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "compact_rep.h"
+#include "distance.h"
+#include "quantity_array.h"
+#include "temperature.h"
+#include "units_atomic.h"
+#include "units_cast_n.h"
+#include "units_chrono.h"
+#include "units_expr.h"
+#include "units_pack.h"
+#include "units_pair.h"
+#include "units_point.h"
+#include "units_reduce.h"
+#include "units_runtime.h"
+#include "units_sort.h"
+#include "units_table.h"
+#include "weight.h"
+
+namespace {
+
+using inches = units::inches<float>;
+using feet = units::feet<float>;
+using millimeters = units::millimeters<float>;
+
+// Values per iteration of the element-wise benchmarks
+constexpr std::size_t batch = 1024;
+
+// Units and raw baselines get their inputs the same way, so the compiler
+// knows no more about one than the other
+template <typename T, typename = void>
+struct value_rep {
+    using type = T;
+};
+
+template <typename T>
+struct value_rep<T, typename std::enable_if<units::is_unit<T>::value>::type> {
+    using type = typename T::rep;
+};
+
+template <typename T>
+std::vector<T> make_values(std::size_t n) {
+    using rep = typename value_rep<T>::type;
+    std::vector<T> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v.push_back(T(static_cast<rep>(i % 1000) + 1));
+    }
+    return v;
+}
+
+template <typename to_unit, typename from_unit, typename policy>
+void units_cast_batch(benchmark::State &state) {
+    auto in = make_values<from_unit>(batch);
+    std::vector<to_unit> out(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = units::units_cast<to_unit, policy>(in[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+template <typename rep, typename op>
+void raw_batch(benchmark::State &state) {
+    auto in = make_values<rep>(batch);
+    std::vector<rep> out(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = op()(in[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+// Raw equivalents of each units_cast_impl specialization
+struct raw_identity {
+    float operator()(float x) const { return x; }
+};
+struct raw_multiply {
+    float operator()(float x) const { return x * 12.f; }
+};
+struct raw_divide {
+    float operator()(float x) const { return x / 12.f; }
+};
+struct raw_scale {
+    float operator()(float x) const { return x * (5.f / 127.f); }
+};
+struct raw_int_scale {
+    int operator()(int x) const { return x * 5 / 127; }
+};
+
+namespace policy = units::cast_policy;
+
+// units_cast, one benchmark per implementation
+BENCHMARK_TEMPLATE(units_cast_batch, inches, inches, policy::automatic);
+BENCHMARK_TEMPLATE(raw_batch, float, raw_identity);
+BENCHMARK_TEMPLATE(units_cast_batch, inches, feet, policy::automatic);
+BENCHMARK_TEMPLATE(raw_batch, float, raw_multiply);
+BENCHMARK_TEMPLATE(units_cast_batch, feet, inches, policy::automatic);
+BENCHMARK_TEMPLATE(units_cast_batch, feet, inches, policy::exact);
+BENCHMARK_TEMPLATE(raw_batch, float, raw_divide);
+BENCHMARK_TEMPLATE(units_cast_batch, inches, millimeters, policy::automatic);
+BENCHMARK_TEMPLATE(units_cast_batch, inches, millimeters, policy::exact);
+BENCHMARK_TEMPLATE(units_cast_batch, inches, millimeters, policy::saturating);
+BENCHMARK_TEMPLATE(raw_batch, float, raw_scale);
+BENCHMARK_TEMPLATE(units_cast_batch, units::inches<int>, units::millimeters<int>,
+                   policy::automatic);
+BENCHMARK_TEMPLATE(units_cast_batch, units::inches<int>,
+                   units::millimeters<std::int16_t>, policy::exact);
+BENCHMARK_TEMPLATE(raw_batch, int, raw_int_scale);
+
+// Scalar and compound arithmetic
+void units_arithmetic(benchmark::State &state) {
+    auto a = make_values<inches>(batch);
+    auto b = make_values<inches>(batch);
+    std::vector<inches> out(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            inches v = a[i] + b[i];
+            v *= 2.f;
+            v -= b[i];
+            out[i] = v / 3.f;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(units_arithmetic);
+
+void raw_arithmetic(benchmark::State &state) {
+    auto a = make_values<float>(batch);
+    auto b = make_values<float>(batch);
+    std::vector<float> out(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            float v = a[i] + b[i];
+            v *= 2.f;
+            v -= b[i];
+            out[i] = v / 3.f;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(raw_arithmetic);
+
+// Mixed unit compound addition converts on every call
+void units_mixed_add(benchmark::State &state) {
+    auto a = make_values<inches>(batch);
+    auto b = make_values<millimeters>(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            a[i] += b[i];
+        }
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(units_mixed_add);
+
+void raw_mixed_add(benchmark::State &state) {
+    auto a = make_values<float>(batch);
+    auto b = make_values<float>(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            a[i] += b[i] * (5.f / 127.f);
+        }
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(raw_mixed_add);
+
+// Binary mixed unit addition scales each operand once into the common unit
+void units_mixed_binary_add(benchmark::State &state) {
+    using common = std::common_type<inches, millimeters>::type;
+    auto a = make_values<inches>(batch);
+    auto b = make_values<millimeters>(batch);
+    std::vector<common> c(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            c[i] = a[i] + b[i];
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(units_mixed_binary_add);
+
+void raw_mixed_binary_add(benchmark::State &state) {
+    auto a = make_values<float>(batch);
+    auto b = make_values<float>(batch);
+    std::vector<float> c(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            c[i] = a[i] * 127.f + b[i] * 5.f;
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(raw_mixed_binary_add);
+
+// Velocity from distance deltas and std::chrono timestamps, in meters per
+// second. The rate's fraction is folded at compile time, so the cast is a
+// single multiply after the divide.
+void units_chrono_velocity(benchmark::State &state) {
+    using meters_per_second =
+        units::units_divide<units::meters<float>, units::seconds<float> >;
+    using microseconds = std::chrono::duration<float, std::micro>;
+    auto d = make_values<millimeters>(batch);
+    auto t = make_values<float>(batch);
+    std::vector<meters_per_second> v(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            v[i] = units::units_cast<meters_per_second>(
+                d[i] / microseconds(t[i]));
+        }
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(units_chrono_velocity);
+
+void raw_velocity(benchmark::State &state) {
+    auto d = make_values<float>(batch);
+    auto t = make_values<float>(batch);
+    std::vector<float> v(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            v[i] = d[i] / t[i] * 1000.f;
+        }
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(raw_velocity);
+
+// Comparison operators
+void units_compare(benchmark::State &state) {
+    auto a = make_values<inches>(batch);
+    auto b = make_values<inches>(batch);
+    std::reverse(b.begin(), b.end());
+    for (auto _ : state) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < batch; ++i) {
+            n += a[i] < b[i];
+        }
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(units_compare);
+
+void raw_compare(benchmark::State &state) {
+    auto a = make_values<float>(batch);
+    auto b = make_values<float>(batch);
+    std::reverse(b.begin(), b.end());
+    for (auto _ : state) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < batch; ++i) {
+            n += a[i] < b[i];
+        }
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(raw_compare);
+
+// units_pair construction converts both operands
+void units_pair_construct(benchmark::State &state) {
+    using stones_per_inch = units::units_pair<units::stones<float>, inches,
+                                              std::divides<float> >;
+    auto w = make_values<units::pounds<float> >(batch);
+    auto d = make_values<millimeters>(batch);
+    std::vector<stones_per_inch> out(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = stones_per_inch(w[i], d[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(units_pair_construct);
+
+void raw_pair_construct(benchmark::State &state) {
+    auto w = make_values<float>(batch);
+    auto d = make_values<float>(batch);
+    std::vector<float> out(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = w[i] * (1.f / 14.f) / (d[i] * (5.f / 127.f));
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(raw_pair_construct);
+
+// Large array throughput, in bytes converted
+void units_cast_n_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    auto in = make_values<millimeters>(n);
+    units::quantity_array<inches> out(n);
+    for (auto _ : state) {
+        units::units_cast_n(in.data(), n, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 2);
+}
+BENCHMARK(units_cast_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+void raw_cast_n_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    auto in = make_values<float>(n);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = in[i] * (5.f / 127.f);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 2);
+}
+BENCHMARK(raw_cast_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// Units known only at runtime: one matrix lookup, then the same kernels
+void units_runtime_cast_n_throughput(benchmark::State &state) {
+    using distance_tag = units::detail::distance_tag;
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const auto from = units::find_unit_id<distance_tag>("mm");
+    const auto to = units::find_unit_id<distance_tag>("in");
+    auto in = make_values<float>(n);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        units::units_cast_n(from, to, in.data(), n, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 2);
+}
+BENCHMARK(units_runtime_cast_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// Affine conversion: one fused multiply-add per value
+void units_point_cast_n_throughput(benchmark::State &state) {
+    using celsius = units::celsius_point<float>;
+    using fahrenheit = units::fahrenheit_point<float>;
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    auto in = make_values<float>(n);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        units::units_point_cast_n<fahrenheit, celsius>(in.data(), n, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 2);
+}
+BENCHMARK(units_point_cast_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+void raw_point_cast_n_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    auto in = make_values<float>(n);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = in[i] * 1.8f + 32.f;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 2);
+}
+BENCHMARK(raw_point_cast_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// Half the bytes of float storage, converted with F16C where available
+void units_pack_n_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    auto in = make_values<float>(n);
+    std::vector<units::float16> out(n);
+    for (auto _ : state) {
+        units::pack_n(in.data(), n, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * (sizeof(float) + 2));
+}
+BENCHMARK(units_pack_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+void units_unpack_n_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    auto values = make_values<float>(n);
+    std::vector<units::float16> in(values.begin(), values.end());
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        units::unpack_n(in.data(), n, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * (sizeof(float) + 2));
+}
+BENCHMARK(units_unpack_n_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// a + b * 2 - c over three units: one fused pass, against converting each
+// operand into a temporary first
+void units_expr_fused(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    units::quantity_array<units::inches<float> > a(n, units::inches<float>{1.f});
+    units::quantity_array<units::millimeters<float> > b(n, units::millimeters<float>{2.f});
+    units::quantity_array<units::feet<float> > c(n, units::feet<float>{3.f});
+    units::quantity_array<units::millimeters<float> > out(n);
+    for (auto _ : state) {
+        units::evaluate(a + b * 2.f - c, out.span());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 4);
+}
+BENCHMARK(units_expr_fused)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+void units_expr_eager(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    units::quantity_array<units::inches<float> > a(n, units::inches<float>{1.f});
+    units::quantity_array<units::millimeters<float> > b(n, units::millimeters<float>{2.f});
+    units::quantity_array<units::feet<float> > c(n, units::feet<float>{3.f});
+    units::quantity_array<units::millimeters<float> > out(n);
+    for (auto _ : state) {
+        auto a_mm = a.convert_to<units::millimeters<float> >();
+        auto c_mm = c.convert_to<units::millimeters<float> >();
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = a_mm[i] + b[i] * 2.f - c_mm[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float) * 4);
+}
+BENCHMARK(units_expr_eager)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// Sorting distances: radix on the amounts' bit patterns against std::sort
+// with the unit comparison operators
+units::quantity_array<units::meters<float> > random_meters(std::size_t n) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> real(-1e4f, 1e4f);
+    units::quantity_array<units::meters<float> > values(n);
+    for (auto &v : values) {
+        v = units::meters<float>{real(gen)};
+    }
+    return values;
+}
+
+void units_radix_sort(benchmark::State &state) {
+    const auto input = random_meters(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto values = input;
+        state.ResumeTiming();
+        units::radix_sort(values.span());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(units_radix_sort)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+void units_std_sort(benchmark::State &state) {
+    const auto input = random_meters(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto values = input;
+        state.ResumeTiming();
+        std::sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(units_std_sort)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// Contended totals: every thread adds to one counter, or to its own shard
+units::atomic_units<units::meters<double> > shared_total;
+units::sharded_units<units::meters<double> > sharded_total;
+
+void units_atomic_fetch_add(benchmark::State &state) {
+    const units::millimeters<double> step{1.};
+    for (auto _ : state) {
+        shared_total.fetch_add(step, std::memory_order_relaxed);
+    }
+}
+BENCHMARK(units_atomic_fetch_add)->ThreadRange(1, 8);
+
+void units_sharded_add(benchmark::State &state) {
+    const units::millimeters<double> step{1.};
+    for (auto _ : state) {
+        sharded_total.add(step);
+    }
+}
+BENCHMARK(units_sharded_add)->ThreadRange(1, 8);
+
+// Calibration curve: a table lookup per key, batched or one at a time
+units::piecewise_table<units::millimeters<float>, units::kilograms<float> >
+calibration_table(std::size_t points) {
+    std::vector<units::millimeters<float> > keys;
+    std::vector<units::kilograms<float> > values;
+    for (std::size_t i = 0; i < points; ++i) {
+        keys.push_back(units::millimeters<float>{static_cast<float>(i * i)});
+        values.push_back(units::kilograms<float>{static_cast<float>(i % 13)});
+    }
+    return {keys, values};
+}
+
+units::quantity_array<units::centimeters<float> > calibration_keys(std::size_t n) {
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<float> real(0.f, 1e4f);
+    units::quantity_array<units::centimeters<float> > keys(n);
+    for (auto &k : keys) {
+        k = units::centimeters<float>{real(gen)};
+    }
+    return keys;
+}
+
+void units_table_batch(benchmark::State &state) {
+    const auto table = calibration_table(static_cast<std::size_t>(state.range(0)));
+    const auto keys = calibration_keys(1 << 16);
+    units::quantity_array<units::kilograms<float> > out(keys.size());
+    for (auto _ : state) {
+        table.evaluate(keys.span(), out.span());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(units_table_batch)->Arg(16)->Arg(256)->Arg(4096);
+
+void units_table_scalar(benchmark::State &state) {
+    const auto table = calibration_table(static_cast<std::size_t>(state.range(0)));
+    const auto keys = calibration_keys(1 << 16);
+    units::quantity_array<units::kilograms<float> > out(keys.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            out[i] = table(keys[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(units_table_scalar)->Arg(16)->Arg(256)->Arg(4096);
+
+void units_sum_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    units::quantity_array<units::grams<float> > in(n, units::grams<float>{1.f});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(units::sum(in.span()));
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float));
+}
+BENCHMARK(units_sum_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// A serial sum into the same wider accumulator
+void raw_sum_throughput(benchmark::State &state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<float> in(n, 1.f);
+    for (auto _ : state) {
+        double total = 0.;
+        for (std::size_t i = 0; i < n; ++i) {
+            total += in[i];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float));
+}
+BENCHMARK(raw_sum_throughput)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+// Compile time benchmark: instantiates units_cast for every pair of aliases in
+// a dimension, for every rep and cast policy. It is not meant to be run; build
+// the units_compile_bench target to get the compiler's time and memory report
+// and compare it between releases.
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "distance.h"
+#include "duration.h"
+#include "units_cast.h"
+#include "weight.h"
+
+namespace {
+
+template <template <typename> class... aliases>
+struct alias_list {};
+
+using distances = alias_list<units::inches, units::feet, units::yards, units::miles, units::nautical_miles,
+    units::meters, units::micrometers, units::millimeters, units::centimeters, units::kilometers>;
+using weights = alias_list<units::ounces, units::pounds, units::stones, units::short_tons, units::long_tons,
+    units::grams, units::micrograms, units::kilograms, units::metric_tons>;
+using durations = alias_list<units::seconds, units::nanoseconds, units::microseconds, units::milliseconds,
+    units::minutes, units::hours>;
+
+using reps = std::tuple<std::int32_t, std::int64_t, float, double>;
+// rounded<> is left out: it rejects integer casts that can overflow, which most
+// of the far apart pairs do
+using policies = std::tuple<units::cast_policy::automatic, units::cast_policy::fused,
+    units::cast_policy::saturating>;
+
+template <typename to, typename policy, typename from>
+double cast_one(from value) {
+    return static_cast<double>(units::units_cast<to, policy>(value).amount());
+}
+
+// One cell of the matrix: every target alias from a single source unit
+template <typename from, typename policy, typename rep, template <typename> class... to>
+double cast_row(alias_list<to...>) {
+    double total = 0;
+    for (double d : {cast_one<to<rep>, policy>(from(1))...}) {
+        total += d;
+    }
+    return total;
+}
+
+template <typename policy, typename rep, typename list, template <typename> class... from>
+double cast_table(alias_list<from...>) {
+    double total = 0;
+    for (double d : {cast_row<from<rep>, policy, rep>(list())...}) {
+        total += d;
+    }
+    return total;
+}
+
+template <typename list, typename policy, std::size_t... r>
+double cast_policy_rows(std::index_sequence<r...>) {
+    double total = 0;
+    for (double d : {cast_table<policy, typename std::tuple_element<r, reps>::type, list>(list())...}) {
+        total += d;
+    }
+    return total;
+}
+
+template <typename list, std::size_t... p>
+double cast_matrix(std::index_sequence<p...>) {
+    double total = 0;
+    for (double d : {cast_policy_rows<list, typename std::tuple_element<p, policies>::type>(
+             std::make_index_sequence<std::tuple_size<reps>::value>())...}) {
+        total += d;
+    }
+    return total;
+}
+
+} // namespace
+
+int main() {
+    auto const p = std::make_index_sequence<std::tuple_size<policies>::value>();
+    double const total = cast_matrix<distances>(p) + cast_matrix<weights>(p) + cast_matrix<durations>(p);
+    return total > 0 ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+#ifndef COMPACT_REP_H
+#define COMPACT_REP_H
+
+// STL
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "units_traits.h"
+
+namespace units {
+
+namespace detail {
+
+// Tag of the constructors taking a compact rep's stored bits
+struct compact_bits {};
+
+} // namespace detail
+
+// Compact storage reps. Each stores fewer bits than the floating point type
+// it computes in, converts to and from it implicitly, and treats every
+// operation as an operation on that type. They are meant for holding large
+// numbers of quantities; arithmetic on them is no faster than on float.
+
+// IEEE 754 binary16: 1 sign, 5 exponent and 10 mantissa bits
+struct float16 {
+    std::uint16_t bits;
+
+    float16() = default;
+    float16(float v) noexcept : bits(from_float(v)) {}
+    constexpr float16(detail::compact_bits, std::uint16_t b) noexcept : bits(b) {}
+
+    operator float() const noexcept { return to_float(bits); }
+
+    float16& operator+=(float v) noexcept { return *this = float(*this) + v; }
+    float16& operator-=(float v) noexcept { return *this = float(*this) - v; }
+    float16& operator*=(float v) noexcept { return *this = float(*this) * v; }
+    float16& operator/=(float v) noexcept { return *this = float(*this) / v; }
+
+    // Round to nearest even, with overflow to infinity and subnormals
+    static std::uint16_t from_float(float v) noexcept {
+        std::uint32_t f;
+        std::memcpy(&f, &v, sizeof f);
+        const std::uint32_t sign = (f >> 16) & 0x8000u;
+        const std::uint32_t abs = f & 0x7fffffffu;
+        if (abs >= 0x7f800000u) {
+            // Infinity, or a quiet NaN
+            return static_cast<std::uint16_t>(
+                sign | 0x7c00u | (abs > 0x7f800000u ? 0x200u : 0u));
+        }
+        if (abs >= 0x477ff000u) {
+            return static_cast<std::uint16_t>(sign | 0x7c00u);
+        }
+        if (abs < 0x38800000u) {
+            // Subnormal: let the float adder round the shifted mantissa
+            float a;
+            std::memcpy(&a, &abs, sizeof a);
+            a += 0.5f;
+            std::uint32_t r;
+            std::memcpy(&r, &a, sizeof r);
+            return static_cast<std::uint16_t>(sign | (r - 0x3f000000u));
+        }
+        const std::uint32_t odd = (abs >> 13) & 1u;
+        return static_cast<std::uint16_t>(
+            sign | ((abs + 0xc8000fffu + odd) >> 13));
+    }
+
+    static float to_float(std::uint16_t h) noexcept {
+        const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+        const std::uint32_t exp = (h >> 10) & 0x1fu;
+        const std::uint32_t mant = h & 0x3ffu;
+        std::uint32_t f;
+        if (exp == 0x1fu) {
+            f = sign | 0x7f800000u | (mant << 13);
+        } else if (exp != 0) {
+            f = sign | ((exp + 112) << 23) | (mant << 13);
+        } else {
+            // Zero or subnormal, exactly representable as a float
+            const float m = static_cast<float>(mant) * 5.9604644775390625e-8f;
+            std::memcpy(&f, &m, sizeof f);
+            f |= sign;
+        }
+        float v;
+        std::memcpy(&v, &f, sizeof v);
+        return v;
+    }
+};
+
+// bfloat16: the upper half of a float, 8 exponent and 7 mantissa bits
+struct bfloat16 {
+    std::uint16_t bits;
+
+    bfloat16() = default;
+    bfloat16(float v) noexcept : bits(from_float(v)) {}
+    constexpr bfloat16(detail::compact_bits, std::uint16_t b) noexcept : bits(b) {}
+
+    operator float() const noexcept { return to_float(bits); }
+
+    bfloat16& operator+=(float v) noexcept { return *this = float(*this) + v; }
+    bfloat16& operator-=(float v) noexcept { return *this = float(*this) - v; }
+    bfloat16& operator*=(float v) noexcept { return *this = float(*this) * v; }
+    bfloat16& operator/=(float v) noexcept { return *this = float(*this) / v; }
+
+    // Round to nearest even, keeping NaNs quiet
+    static std::uint16_t from_float(float v) noexcept {
+        std::uint32_t f;
+        std::memcpy(&f, &v, sizeof f);
+        if ((f & 0x7fffffffu) > 0x7f800000u) {
+            return static_cast<std::uint16_t>((f >> 16) | 0x40u);
+        }
+        return static_cast<std::uint16_t>(
+            (f + 0x7fffu + ((f >> 16) & 1u)) >> 16);
+    }
+
+    static float to_float(std::uint16_t b) noexcept {
+        const std::uint32_t f = static_cast<std::uint32_t>(b) << 16;
+        float v;
+        std::memcpy(&v, &f, sizeof v);
+        return v;
+    }
+};
+
+namespace detail {
+
+// Floating point type a fixed point rep computes in: wide enough to hold
+// every raw value exactly
+template <typename int_rep>
+using fixed_point_compute = typename std::conditional<
+    (sizeof(int_rep) < 3), float, double>::type;
+
+} // namespace detail
+
+// Fixed point: a raw integer counting steps of scale, a compile time
+// std::ratio. Conversion from floating point rounds to nearest and
+// saturates at the range of int_rep.
+template <typename int_rep_, typename scale_>
+struct fixed_point {
+    static_assert(std::is_integral<int_rep_>::value,
+                  "fixed_point must be over an integral rep");
+
+    using int_rep = int_rep_;
+    using scale = scale_;
+    using compute = detail::fixed_point_compute<int_rep>;
+
+    int_rep raw;
+
+    fixed_point() = default;
+    fixed_point(compute v) noexcept : raw(from_compute(v)) {}
+    constexpr fixed_point(detail::compact_bits, int_rep r) noexcept : raw(r) {}
+
+    operator compute() const noexcept {
+        return static_cast<compute>(raw) * step();
+    }
+
+    fixed_point& operator+=(compute v) noexcept { return *this = compute(*this) + v; }
+    fixed_point& operator-=(compute v) noexcept { return *this = compute(*this) - v; }
+    fixed_point& operator*=(compute v) noexcept { return *this = compute(*this) * v; }
+    fixed_point& operator/=(compute v) noexcept { return *this = compute(*this) / v; }
+
+    static constexpr compute step() noexcept {
+        return static_cast<compute>(static_cast<long double>(scale::num) /
+                                    static_cast<long double>(scale::den));
+    }
+
+    static int_rep from_compute(compute v) noexcept {
+        using limits = std::numeric_limits<int_rep>;
+        const compute r = std::nearbyint(v / step());
+        return !(r > static_cast<compute>(limits::lowest())) ? limits::lowest() :
+            !(r < static_cast<compute>(limits::max())) ? limits::max() :
+            static_cast<int_rep>(r);
+    }
+};
+
+template <>
+struct treat_as_floating_point<float16> : std::true_type {};
+
+template <>
+struct treat_as_floating_point<bfloat16> : std::true_type {};
+
+template <typename int_rep, typename scale>
+struct treat_as_floating_point<fixed_point<int_rep, scale> > : std::true_type {};
+
+// Compact reps compute in a floating point type, so arithmetic and casts
+// between them, and with arithmetic reps, happen in that type
+template <>
+struct compute_rep<float16> {
+    using type = float;
+};
+
+template <>
+struct compute_rep<bfloat16> {
+    using type = float;
+};
+
+template <typename int_rep, typename scale>
+struct compute_rep<fixed_point<int_rep, scale> > {
+    using type = typename fixed_point<int_rep, scale>::compute;
+};
+
+} // namespace units
+
+// Limits of the compact reps, so that saturating casts and reductions see
+// their real range
+template <>
+class std::numeric_limits<units::float16> {
+    static constexpr units::float16 from_bits(std::uint16_t b) noexcept {
+        return units::float16(units::detail::compact_bits(), b);
+    }
+
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr std::float_denorm_style has_denorm = std::denorm_present;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr std::float_round_style round_style = std::round_to_nearest;
+    static constexpr bool is_iec559 = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 11;
+    static constexpr int digits10 = 3;
+    static constexpr int max_digits10 = 5;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = -13;
+    static constexpr int min_exponent10 = -4;
+    static constexpr int max_exponent = 16;
+    static constexpr int max_exponent10 = 4;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+
+    static constexpr units::float16 min() noexcept { return from_bits(0x0400); }
+    static constexpr units::float16 lowest() noexcept { return from_bits(0xfbff); }
+    static constexpr units::float16 max() noexcept { return from_bits(0x7bff); }
+    static constexpr units::float16 epsilon() noexcept { return from_bits(0x1400); }
+    static constexpr units::float16 round_error() noexcept { return from_bits(0x3800); }
+    static constexpr units::float16 infinity() noexcept { return from_bits(0x7c00); }
+    static constexpr units::float16 quiet_NaN() noexcept { return from_bits(0x7e00); }
+    static constexpr units::float16 signaling_NaN() noexcept { return from_bits(0x7d00); }
+    static constexpr units::float16 denorm_min() noexcept { return from_bits(0x0001); }
+};
+
+template <>
+class std::numeric_limits<units::bfloat16> {
+    static constexpr units::bfloat16 from_bits(std::uint16_t b) noexcept {
+        return units::bfloat16(units::detail::compact_bits(), b);
+    }
+
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr std::float_denorm_style has_denorm = std::denorm_present;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr std::float_round_style round_style = std::round_to_nearest;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 8;
+    static constexpr int digits10 = 2;
+    static constexpr int max_digits10 = 4;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = -125;
+    static constexpr int min_exponent10 = -37;
+    static constexpr int max_exponent = 128;
+    static constexpr int max_exponent10 = 38;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+
+    static constexpr units::bfloat16 min() noexcept { return from_bits(0x0080); }
+    static constexpr units::bfloat16 lowest() noexcept { return from_bits(0xff7f); }
+    static constexpr units::bfloat16 max() noexcept { return from_bits(0x7f7f); }
+    static constexpr units::bfloat16 epsilon() noexcept { return from_bits(0x3c00); }
+    static constexpr units::bfloat16 round_error() noexcept { return from_bits(0x3f00); }
+    static constexpr units::bfloat16 infinity() noexcept { return from_bits(0x7f80); }
+    static constexpr units::bfloat16 quiet_NaN() noexcept { return from_bits(0x7fc0); }
+    static constexpr units::bfloat16 signaling_NaN() noexcept { return from_bits(0x7fa0); }
+    static constexpr units::bfloat16 denorm_min() noexcept { return from_bits(0x0001); }
+};
+
+// A fixed point rep has the range and precision of its raw integer, in
+// steps of its scale
+template <typename int_rep, typename scale>
+class std::numeric_limits<units::fixed_point<int_rep, scale> >
+    : public std::numeric_limits<int_rep> {
+    using raw_limits = std::numeric_limits<int_rep>;
+    using fixed = units::fixed_point<int_rep, scale>;
+
+    static constexpr fixed from_raw(int_rep r) noexcept {
+        return fixed(units::detail::compact_bits(), r);
+    }
+
+public:
+    static constexpr bool is_integer = false;
+    static constexpr bool is_modulo = false;
+
+    static constexpr fixed min() noexcept { return from_raw(int_rep(1)); }
+    static constexpr fixed lowest() noexcept { return from_raw(raw_limits::lowest()); }
+    static constexpr fixed max() noexcept { return from_raw((raw_limits::max)()); }
+    static constexpr fixed epsilon() noexcept { return from_raw(int_rep(1)); }
+    static constexpr fixed round_error() noexcept { return from_raw(int_rep(0)); }
+    static constexpr fixed infinity() noexcept { return from_raw(int_rep(0)); }
+    static constexpr fixed quiet_NaN() noexcept { return from_raw(int_rep(0)); }
+    static constexpr fixed signaling_NaN() noexcept { return from_raw(int_rep(0)); }
+    static constexpr fixed denorm_min() noexcept { return from_raw(int_rep(0)); }
+};
+
+#endif//COMPACT_REP_H
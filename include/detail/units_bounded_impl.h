@@ -0,0 +1,124 @@
+#ifndef UNITS_BOUNDED_IMPL_H
+#define UNITS_BOUNDED_IMPL_H
+
+// STL
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "detail/units_cast_policy_impl.h"
+#include "units_traits.h"
+
+namespace units {
+
+namespace detail {
+
+template <typename r1, typename r2>
+using ratio_min = typename std::conditional<std::ratio_less<r2, r1>::value,
+                                            r2, r1>::type;
+
+template <typename r1, typename r2>
+using ratio_max = typename std::conditional<std::ratio_less<r1, r2>::value,
+                                            r2, r1>::type;
+
+template <typename r>
+using ratio_floor = std::ratio<r::num / r::den -
+                               (r::num % r::den != 0 && r::num < 0 ? 1 : 0)>;
+
+template <typename r>
+using ratio_ceil = std::ratio<r::num / r::den +
+                              (r::num % r::den != 0 && r::num > 0 ? 1 : 0)>;
+
+// Bounds a rep can hold. Integral reps hold whole values only, so bounds
+// as declared round inward, and bounds derived from arithmetic or a
+// conversion round outward to cover every rounding of the result.
+template <typename rep, typename lower, typename upper,
+          bool floating = treat_as_floating_point<rep>::value>
+struct bounds_of {
+    using lower_inward = std::ratio<lower::num, lower::den>;
+    using upper_inward = std::ratio<upper::num, upper::den>;
+    using lower_outward = lower_inward;
+    using upper_outward = upper_inward;
+};
+
+template <typename rep, typename lower, typename upper>
+struct bounds_of<rep, lower, upper, false> {
+    using lower_inward = ratio_ceil<lower>;
+    using upper_inward = ratio_floor<upper>;
+    using lower_outward = ratio_floor<lower>;
+    using upper_outward = ratio_ceil<upper>;
+};
+
+// Whether every value within whole bounds fits an integral rep, so that
+// arithmetic proven within them cannot overflow
+template <typename rep, typename lower, typename upper,
+          bool floating = treat_as_floating_point<rep>::value>
+struct bounds_fit_rep : std::true_type {};
+
+template <typename rep, typename lower, typename upper>
+struct bounds_fit_rep<rep, lower, upper, false> : std::integral_constant<bool,
+    static_cast<wide_int>(lower::num) >=
+        static_cast<wide_int>(std::numeric_limits<rep>::lowest()) &&
+    static_cast<wide_int>(upper::num) <=
+        static_cast<wide_int>((std::numeric_limits<rep>::max)())> {};
+
+// A bound as a value of the rep
+template <typename rep, typename bound>
+struct bound_value {
+    static constexpr rep value = units_scale<rep, bound>::value;
+};
+
+template <typename rep, typename bound>
+constexpr rep bound_value<rep, bound>::value;
+
+// Bounds of a unit bounded by lower and upper, converted to to_unit
+template <typename to_unit, typename from_fraction, typename lower, typename upper>
+struct bounds_cast {
+    using scale = std::ratio_divide<from_fraction, typename to_unit::fraction>;
+    using bounds = bounds_of<typename to_unit::rep,
+                             std::ratio_multiply<lower, scale>,
+                             std::ratio_multiply<upper, scale> >;
+    using lower_type = typename bounds::lower_outward;
+    using upper_type = typename bounds::upper_outward;
+};
+
+// Bounds of the product or quotient of two bounded amounts: the least and
+// greatest of the four corners
+template <typename rep, typename c1, typename c2, typename c3, typename c4>
+struct bounds_of_corners {
+    using bounds = bounds_of<rep, ratio_min<ratio_min<c1, c2>, ratio_min<c3, c4> >,
+                             ratio_max<ratio_max<c1, c2>, ratio_max<c3, c4> > >;
+    using lower_type = typename bounds::lower_outward;
+    using upper_type = typename bounds::upper_outward;
+};
+
+// Clamp into bounds, NaN to the lower bound
+template <typename rep>
+constexpr rep bounds_clamp(rep v, rep lower, rep upper) noexcept {
+    return !(v > lower) ? lower : (v < upper ? v : upper);
+}
+
+// Tell the compiler a value lies within its bounds, so that checks of it
+// downstream fold away
+template <typename rep>
+constexpr rep assume_within(rep v, rep lower, rep upper) noexcept {
+#if defined(__GNUC__)
+    if (!(v >= lower && v <= upper)) {
+        __builtin_unreachable();
+    }
+#else
+    (void)lower;
+    (void)upper;
+#endif
+    return v;
+}
+
+// Tag of the constructor taking values whose bounds are already proven
+struct bounds_proven {};
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_BOUNDED_IMPL_H
@@ -0,0 +1,193 @@
+#ifndef UNITS_CAST_N_IMPL_H
+#define UNITS_CAST_N_IMPL_H
+
+// STL
+#include <cstddef>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "units_cast.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UNITS_X86_DISPATCH 1
+#include <immintrin.h>
+#else
+#define UNITS_X86_DISPATCH 0
+#endif
+
+namespace units {
+
+namespace detail {
+
+template <typename rep>
+using scale_kernel = void (*)(const rep*, std::size_t, rep*, rep);
+
+// Scalar kernel: also the fallback, and vectorized by the compiler where it can
+template <typename rep>
+inline void scale_n_scalar(const rep *in, std::size_t n, rep *out, rep factor) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = in[i] * factor;
+    }
+}
+
+#if UNITS_X86_DISPATCH
+
+__attribute__((target("avx2")))
+inline void scale_n_avx2(const float *in, std::size_t n, float *out,
+                         float factor) {
+    const __m256 f = _mm256_set1_ps(factor);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(in + i);
+        __m256 b = _mm256_loadu_ps(in + i + 8);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(a, f));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(b, f));
+    }
+    for (; i < n; ++i) {
+        out[i] = in[i] * factor;
+    }
+}
+
+__attribute__((target("avx2")))
+inline void scale_n_avx2(const double *in, std::size_t n, double *out,
+                         double factor) {
+    const __m256d f = _mm256_set1_pd(factor);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_loadu_pd(in + i);
+        __m256d b = _mm256_loadu_pd(in + i + 4);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(a, f));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(b, f));
+    }
+    for (; i < n; ++i) {
+        out[i] = in[i] * factor;
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void scale_n_avx512(const float *in, std::size_t n, float *out,
+                           float factor) {
+    const __m512 f = _mm512_set1_ps(factor);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(in + i), f));
+    }
+    if (i < n) {
+        const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(out + i, m,
+                              _mm512_mul_ps(_mm512_maskz_loadu_ps(m, in + i), f));
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void scale_n_avx512(const double *in, std::size_t n, double *out,
+                           double factor) {
+    const __m512d f = _mm512_set1_pd(factor);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(in + i), f));
+    }
+    if (i < n) {
+        const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_pd(out + i, m,
+                              _mm512_mul_pd(_mm512_maskz_loadu_pd(m, in + i), f));
+    }
+}
+
+#endif // UNITS_X86_DISPATCH
+
+// Pick the widest kernel the running CPU supports
+template <typename rep>
+inline scale_kernel<rep> select_scale_kernel(std::false_type) {
+    return &scale_n_scalar<rep>;
+}
+
+template <typename rep>
+inline scale_kernel<rep> select_scale_kernel(std::true_type) {
+#if UNITS_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return static_cast<scale_kernel<rep> >(&scale_n_avx512);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return static_cast<scale_kernel<rep> >(&scale_n_avx2);
+    }
+#endif
+    return &scale_n_scalar<rep>;
+}
+
+// Multiply n values by factor; in and out may be the same buffer
+template <typename rep>
+inline void scale_n(const rep *in, std::size_t n, rep *out, rep factor) {
+    using simd = std::integral_constant<bool,
+        std::is_same<rep, float>::value || std::is_same<rep, double>::value>;
+    static const scale_kernel<rep> kernel = select_scale_kernel<rep>(simd());
+    kernel(in, n, out, factor);
+}
+
+// Whether every value of a rep times num fits the wide intermediate of
+// rescale_n, which num from outside the program has to be checked for
+template <typename rep>
+constexpr bool rescale_fits(wide_int, std::true_type) {
+    return true;
+}
+
+template <typename rep>
+constexpr bool rescale_fits(wide_int num, std::false_type) {
+    return wide_int((std::numeric_limits<rep>::max)()) <= wide_int_max / num &&
+        wide_int(std::numeric_limits<rep>::lowest()) >= -(wide_int_max / num);
+}
+
+// Multiply n values by num / den, both only known at runtime; in and out may
+// be the same buffer. Integral results that don't fit the rep saturate, and
+// false is returned if any did. num must pass rescale_fits.
+template <typename rep>
+inline bool rescale_n(const rep *in, std::size_t n, rep *out, wide_int num,
+                      wide_int den, std::true_type) {
+    scale_n(in, n, out, static_cast<rep>(static_cast<long double>(num) /
+                                         static_cast<long double>(den)));
+    return true;
+}
+
+template <typename rep>
+inline bool rescale_n(const rep *in, std::size_t n, rep *out, wide_int num,
+                      wide_int den, std::false_type) {
+    constexpr wide_int lowest = std::numeric_limits<rep>::lowest();
+    constexpr wide_int max = (std::numeric_limits<rep>::max)();
+    bool fits = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        const wide_int w = static_cast<wide_int>(in[i]) * num / den;
+        fits = fits && w >= lowest && w <= max;
+        out[i] = static_cast<rep>(w < lowest ? lowest : (w > max ? max : w));
+    }
+    return fits;
+}
+
+// units_cast_n implementation: general case, converts one value at a time
+template <typename to_unit, typename from_unit, typename common_fraction,
+          bool fold = false>
+struct units_cast_n_impl {
+    template <typename from_rep, typename to_rep>
+    static void cast(const from_rep *in, std::size_t n, to_rep *out) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = units_cast<to_unit>(from_unit(in[i])).amount();
+        }
+    }
+};
+
+// units_cast_n implementation: floating point rep shared by both units, the
+// fraction is folded into one factor and handed to the SIMD kernels
+template <typename to_unit, typename from_unit, typename common_fraction>
+struct units_cast_n_impl<to_unit, from_unit, common_fraction, true> {
+    template <typename rep>
+    static void cast(const rep *in, std::size_t n, rep *out) {
+        scale_n(in, n, out, units_scale<rep, common_fraction>::value);
+    }
+};
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_CAST_N_IMPL_H
@@ -0,0 +1,293 @@
+#ifndef UNITS_CAST_POLICY_IMPL_H
+#define UNITS_CAST_POLICY_IMPL_H
+
+// STL
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "detail/units_cast_impl.h"
+#include "units_cast_policy.h"
+#include "units_fwd.h"
+#include "units_traits.h"
+
+namespace units {
+
+namespace detail {
+
+#if defined(__SIZEOF_INT128__)
+__extension__ using wide_int = __int128;
+#else
+using wide_int = std::intmax_t;
+#endif
+
+constexpr wide_int wide_int_max =
+    ((wide_int(1) << (sizeof(wide_int) * 8 - 2)) - 1) +
+    (wide_int(1) << (sizeof(wide_int) * 8 - 2));
+
+constexpr wide_int wide_gcd(wide_int a, wide_int b) {
+    while (b != 0) {
+        const wide_int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Conversion factor of a fraction folded into a single rep
+template <typename rep, typename fraction>
+struct units_scale {
+    static constexpr rep value = static_cast<rep>(
+        static_cast<long double>(fraction::num) /
+        static_cast<long double>(fraction::den));
+};
+
+template <typename rep, typename fraction>
+constexpr rep units_scale<rep, fraction>::value;
+
+// Range of x * num / den over every value x of an integral rep
+template <typename rep, typename fraction>
+struct wide_scale_range {
+    static constexpr wide_int rep_min = std::numeric_limits<rep>::lowest();
+    static constexpr wide_int rep_max = std::numeric_limits<rep>::max();
+    static constexpr bool intermediate_fits =
+        rep_max <= wide_int_max / fraction::num &&
+        rep_min >= -(wide_int_max / fraction::num);
+    // Narrower intermediate, when it suffices, avoids 128 bit division
+    static constexpr wide_int intmax_max =
+        (std::numeric_limits<std::intmax_t>::max)();
+    static constexpr bool intmax_fits =
+        rep_max <= intmax_max / fraction::num &&
+        rep_min >= -(intmax_max / fraction::num);
+    using intermediate = typename std::conditional<
+        intmax_fits, std::intmax_t, wide_int>::type;
+    static constexpr wide_int min =
+        intermediate_fits ? rep_min * fraction::num / fraction::den : 0;
+    static constexpr wide_int max =
+        intermediate_fits ? rep_max * fraction::num / fraction::den : 0;
+
+    template <typename to_rep>
+    static constexpr bool fits() {
+        return intermediate_fits &&
+            min >= wide_int(std::numeric_limits<to_rep>::lowest()) &&
+            max <= wide_int(std::numeric_limits<to_rep>::max());
+    }
+};
+
+// Integer division rounded by mode
+constexpr wide_int rounded_divide(wide_int v, wide_int d, rounding::truncate) {
+    return v / d;
+}
+
+constexpr wide_int rounded_divide(wide_int v, wide_int d, rounding::floor) {
+    return v / d - (v % d != 0 && v < 0 ? 1 : 0);
+}
+
+constexpr wide_int rounded_divide(wide_int v, wide_int d, rounding::ceil) {
+    return v / d + (v % d != 0 && v > 0 ? 1 : 0);
+}
+
+constexpr wide_int rounded_divide(wide_int v, wide_int d, rounding::nearest) {
+    // d is a positive ratio denominator, so only the sign of v matters
+    const wide_int q = v / d;
+    const wide_int r2 = 2 * (v % d < 0 ? -(v % d) : v % d);
+    const wide_int away = v < 0 ? -1 : 1;
+    return r2 > d || (r2 == d && q % 2 != 0) ? q + away : q;
+}
+
+// Range of rounded x * num / den over every value x of an integral rep
+template <typename rep, typename fraction, typename rounding_mode>
+struct rounded_scale_range {
+    using range = wide_scale_range<rep, fraction>;
+    static constexpr wide_int min = range::intermediate_fits ?
+        rounded_divide(range::rep_min * fraction::num, fraction::den,
+                       rounding_mode()) : 0;
+    static constexpr wide_int max = range::intermediate_fits ?
+        rounded_divide(range::rep_max * fraction::num, fraction::den,
+                       rounding_mode()) : 0;
+
+    template <typename to_rep>
+    static constexpr bool fits() {
+        return range::intermediate_fits &&
+            min >= wide_int(std::numeric_limits<to_rep>::lowest()) &&
+            max <= wide_int(std::numeric_limits<to_rep>::max());
+    }
+};
+
+// unit_cast policy: scale by a single precomputed factor
+template <typename to_unit, typename common_fraction, typename common_rep,
+          bool unity = common_fraction::num == 1 && common_fraction::den == 1>
+struct units_cast_fused {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        using to_rep = typename to_unit::rep;
+        return to_unit(static_cast<to_rep>(
+            static_cast<common_rep>(u.amount()) *
+            units_scale<common_rep, common_fraction>::value));
+    }
+};
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_fused<to_unit, common_fraction, common_rep, true>
+    : units_cast_impl<to_unit, common_fraction, common_rep, true, true> {};
+
+// unit_cast policy: scale in long double, rounding once
+template <typename to_unit, typename common_fraction>
+struct units_cast_long_double {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        using to_rep = typename to_unit::rep;
+        return to_unit(static_cast<to_rep>(
+            static_cast<long double>(u.amount()) *
+            static_cast<long double>(common_fraction::num) /
+            static_cast<long double>(common_fraction::den)));
+    }
+};
+
+// unit_cast policy: clamp a floating point result to the target range
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_saturating_float {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        using to_rep = typename to_unit::rep;
+        using limits = std::numeric_limits<to_rep>;
+        using fused = units_cast_fused<units<common_rep, fraction_, units_tag_>,
+                                       common_fraction, common_rep>;
+        const common_rep v = fused::cast(u).amount();
+        return to_unit(v > static_cast<common_rep>(limits::max()) ? limits::max() :
+                       v < static_cast<common_rep>(limits::lowest()) ? limits::lowest() :
+                       static_cast<to_rep>(v));
+    }
+};
+
+// unit_cast policy: integers through a wide intermediate, optionally
+// clamped to the target range
+template <typename to_unit, typename common_fraction, bool saturate>
+struct units_cast_wide {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        static_assert(wide_scale_range<rep_, common_fraction>::intermediate_fits,
+                      "source rep is too wide to scale exactly");
+        using to_rep = typename to_unit::rep;
+        using limits = std::numeric_limits<to_rep>;
+        using intermediate = typename wide_scale_range<
+            rep_, common_fraction>::intermediate;
+        const intermediate v = static_cast<intermediate>(u.amount()) *
+            common_fraction::num / common_fraction::den;
+        return to_unit(!saturate ? static_cast<to_rep>(v) :
+                       wide_int(v) > wide_int(limits::max()) ? limits::max() :
+                       wide_int(v) < wide_int(limits::lowest()) ? limits::lowest() :
+                       static_cast<to_rep>(v));
+    }
+};
+
+// unit_cast policy: the wide intermediate when it holds every scaled value
+// of the source rep, and otherwise plain arithmetic in the common rep, as
+// for 64 bit reps on targets without a 128 bit type
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_automatic_int {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        using impl = typename std::conditional<
+            wide_scale_range<rep_, common_fraction>::intermediate_fits,
+            units_cast_wide<to_unit, common_fraction, false>,
+            units_cast_impl<to_unit, common_fraction, common_rep> >::type;
+        return impl::cast(u);
+    }
+};
+
+// unit_cast policy: integers through a wide intermediate, proven in range
+template <typename to_unit, typename common_fraction>
+struct units_cast_exact_int {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        static_assert(wide_scale_range<rep_, common_fraction>::template
+                          fits<typename to_unit::rep>(),
+                      "exact cast can overflow the target rep");
+        return units_cast_wide<to_unit, common_fraction, false>::cast(u);
+    }
+};
+
+// unit_cast policy: integers rounded by mode, proven in range
+template <typename to_unit, typename common_fraction, typename rounding_mode>
+struct units_cast_rounded {
+    template <typename rep_, typename fraction_, typename units_tag_>
+    static constexpr to_unit cast(const units<rep_, fraction_, units_tag_> &u) {
+        using to_rep = typename to_unit::rep;
+        static_assert(std::is_integral<rep_>::value &&
+                      std::is_integral<to_rep>::value,
+                      "rounded casts are only defined for integral reps");
+        static_assert(rounded_scale_range<rep_, common_fraction, rounding_mode>::
+                          template fits<to_rep>(),
+                      "rounded cast can overflow the target rep");
+        return to_unit(static_cast<to_rep>(rounded_divide(
+            static_cast<wide_int>(u.amount()) * common_fraction::num,
+            common_fraction::den, rounding_mode())));
+    }
+};
+
+// Choose the implementation of a policy for a pair of units
+template <typename policy, typename to_unit, typename common_fraction,
+          typename common_rep,
+          bool floating = treat_as_floating_point<common_rep>::value>
+struct units_cast_policy_impl;
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::automatic, to_unit, common_fraction,
+                              common_rep, true>
+    : units_cast_fused<to_unit, common_fraction, common_rep> {};
+
+// Integers only need the wide intermediate when scaling by num and den
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::automatic, to_unit, common_fraction,
+                              common_rep, false>
+    : std::conditional<common_fraction::num == 1 || common_fraction::den == 1,
+          units_cast_impl<to_unit, common_fraction, common_rep,
+                          common_fraction::num == 1, common_fraction::den == 1>,
+          units_cast_automatic_int<to_unit, common_fraction, common_rep> >::type {};
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::fused, to_unit, common_fraction,
+                              common_rep, true>
+    : units_cast_fused<to_unit, common_fraction, common_rep> {};
+
+// An integral factor is only exact for whole fractions, so integers keep
+// scaling by num and den separately
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::fused, to_unit, common_fraction,
+                              common_rep, false>
+    : units_cast_impl<to_unit, common_fraction, common_rep,
+                      common_fraction::num == 1, common_fraction::den == 1> {};
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::exact, to_unit, common_fraction,
+                              common_rep, true>
+    : units_cast_long_double<to_unit, common_fraction> {};
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::exact, to_unit, common_fraction,
+                              common_rep, false>
+    : units_cast_exact_int<to_unit, common_fraction> {};
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::saturating, to_unit,
+                              common_fraction, common_rep, true>
+    : units_cast_saturating_float<to_unit, common_fraction, common_rep> {};
+
+template <typename to_unit, typename common_fraction, typename common_rep>
+struct units_cast_policy_impl<cast_policy::saturating, to_unit,
+                              common_fraction, common_rep, false>
+    : units_cast_wide<to_unit, common_fraction, true> {};
+
+template <typename rounding_mode, typename to_unit, typename common_fraction,
+          typename common_rep, bool floating>
+struct units_cast_policy_impl<cast_policy::rounded<rounding_mode>, to_unit,
+                              common_fraction, common_rep, floating>
+    : units_cast_rounded<to_unit, common_fraction, rounding_mode> {};
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_CAST_POLICY_IMPL_H
@@ -0,0 +1,358 @@
+#ifndef UNITS_EXPR_IMPL_H
+#define UNITS_EXPR_IMPL_H
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "detail/units_cast_policy_impl.h"
+#include "dimension.h"
+#include "quantity_array.h"
+#include "units.h"
+#include "units_traits.h"
+
+namespace units {
+
+namespace detail {
+
+// Type an expression computes in: floating point reps as they compute,
+// integral reps in double so that folded factors keep their fraction
+template <typename rep>
+using expr_compute = typename std::conditional<
+    treat_as_floating_point<rep>::value,
+    typename compute_rep<rep>::type, double>::type;
+
+// Multiply by a compile time ratio, or by nothing when it is one
+template <typename compute, typename ratio>
+constexpr compute expr_scale(compute v) noexcept {
+    return ratio::num == ratio::den ? v : v * units_scale<compute, ratio>::value;
+}
+
+// Every node has a compute type, the fraction and tag of the unit it
+// naturally evaluates in, a size, and eval<to_fraction>(i), element i in
+// to_fraction with all conversion factors folded at compile time.
+// overlaps(first, last, element) tells whether any of its ranges overlaps
+// the bytes [first, last) other than element for element, for elements of
+// that size.
+
+inline bool expr_overlaps(const void *data, std::size_t bytes, std::size_t size,
+                          std::uintptr_t first, std::uintptr_t last,
+                          std::size_t element) noexcept {
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+    const std::uintptr_t end = begin + bytes;
+    return !(begin == first && size == element) && begin < last && first < end;
+}
+
+// A range of units
+template <typename unit>
+struct expr_leaf {
+    using compute = expr_compute<typename unit::rep>;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+
+    const typename unit::rep *data;
+    std::size_t count;
+
+    std::size_t size() const noexcept { return count; }
+
+    bool overlaps(std::uintptr_t first, std::uintptr_t last,
+                  std::size_t element) const noexcept {
+        return expr_overlaps(data, count * sizeof(*data), sizeof(*data),
+                             first, last, element);
+    }
+
+    template <typename to_fraction>
+    compute eval(std::size_t i) const noexcept {
+        return expr_scale<compute, std::ratio_divide<fraction, to_fraction> >(
+            static_cast<compute>(data[i]));
+    }
+};
+
+// A single unit applied to every element
+template <typename unit>
+struct expr_constant {
+    using compute = expr_compute<typename unit::rep>;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+
+    compute value;
+
+    std::size_t size() const noexcept {
+        return (std::numeric_limits<std::size_t>::max)();
+    }
+
+    bool overlaps(std::uintptr_t, std::uintptr_t, std::size_t) const noexcept {
+        return false;
+    }
+
+    template <typename to_fraction>
+    compute eval(std::size_t) const noexcept {
+        return expr_scale<compute, std::ratio_divide<fraction, to_fraction> >(
+            value);
+    }
+};
+
+// Sum or difference, in the common fraction of the operands
+template <typename lhs, typename rhs, bool subtract>
+struct expr_add {
+    static_assert(std::is_same<typename lhs::units_tag,
+                               typename rhs::units_tag>::value,
+                  "units must have the same dimension to be added");
+
+    using compute = common_rep<typename lhs::compute, typename rhs::compute>;
+    using fraction = common_units_fraction<typename lhs::fraction,
+                                           typename rhs::fraction>;
+    using units_tag = typename lhs::units_tag;
+
+    lhs l;
+    rhs r;
+
+    std::size_t size() const noexcept { return std::min(l.size(), r.size()); }
+
+    bool overlaps(std::uintptr_t first, std::uintptr_t last,
+                  std::size_t element) const noexcept {
+        return l.overlaps(first, last, element) || r.overlaps(first, last, element);
+    }
+
+    template <typename to_fraction>
+    compute eval(std::size_t i) const noexcept {
+        const compute a = l.template eval<to_fraction>(i);
+        const compute b = r.template eval<to_fraction>(i);
+        return subtract ? a - b : a + b;
+    }
+};
+
+// Product or quotient, a composite unit as units_multiply and units_divide
+template <typename lhs, typename rhs, bool divide>
+struct expr_multiply {
+    using compute = common_rep<typename lhs::compute, typename rhs::compute>;
+    using lhs_unit = units<compute, typename lhs::fraction,
+                           typename lhs::units_tag>;
+    using rhs_unit = units<compute, typename rhs::fraction,
+                           typename rhs::units_tag>;
+    using unit = typename std::conditional<divide,
+        units_divide<lhs_unit, rhs_unit>,
+        units_multiply<lhs_unit, rhs_unit> >::type;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+
+    lhs l;
+    rhs r;
+
+    std::size_t size() const noexcept { return std::min(l.size(), r.size()); }
+
+    bool overlaps(std::uintptr_t first, std::uintptr_t last,
+                  std::size_t element) const noexcept {
+        return l.overlaps(first, last, element) || r.overlaps(first, last, element);
+    }
+
+    template <typename to_fraction>
+    compute eval(std::size_t i) const noexcept {
+        const compute a = l.template eval<typename lhs::fraction>(i);
+        const compute b = r.template eval<typename rhs::fraction>(i);
+        return expr_scale<compute, std::ratio_divide<fraction, to_fraction> >(
+            divide ? a / b : a * b);
+    }
+};
+
+// Product or quotient with a dimensionless scalar
+template <typename node, typename scalar, bool divide>
+struct expr_scalar {
+    using compute = common_rep<typename node::compute, scalar>;
+    using fraction = typename node::fraction;
+    using units_tag = typename node::units_tag;
+
+    node e;
+    compute s;
+
+    std::size_t size() const noexcept { return e.size(); }
+
+    bool overlaps(std::uintptr_t first, std::uintptr_t last,
+                  std::size_t element) const noexcept {
+        return e.overlaps(first, last, element);
+    }
+
+    template <typename to_fraction>
+    compute eval(std::size_t i) const noexcept {
+        const compute a = e.template eval<to_fraction>(i);
+        return divide ? a / s : a * s;
+    }
+};
+
+template <typename node>
+struct expr_negate {
+    using compute = typename node::compute;
+    using fraction = typename node::fraction;
+    using units_tag = typename node::units_tag;
+
+    node e;
+
+    std::size_t size() const noexcept { return e.size(); }
+
+    bool overlaps(std::uintptr_t first, std::uintptr_t last,
+                  std::size_t element) const noexcept {
+        return e.overlaps(first, last, element);
+    }
+
+    template <typename to_fraction>
+    compute eval(std::size_t i) const noexcept {
+        return -e.template eval<to_fraction>(i);
+    }
+};
+
+// Nodes an operand becomes; only ranges and nodes make an expression lazy
+template <typename T>
+struct expr_operand {
+    static constexpr bool lazy = false;
+};
+
+template <typename unit>
+struct expr_operand<quantity_span<unit> > {
+    static constexpr bool lazy = true;
+    using type = expr_leaf<typename std::remove_const<unit>::type>;
+    static type make(const quantity_span<unit> &s) noexcept {
+        return type{s.raw_data(), s.size()};
+    }
+};
+
+template <typename unit>
+struct expr_operand<quantity_array<unit> > {
+    static constexpr bool lazy = true;
+    using type = expr_leaf<unit>;
+    static type make(const quantity_array<unit> &a) noexcept {
+        return type{a.raw_data(), a.size()};
+    }
+};
+
+template <typename rep, typename fraction, typename units_tag>
+struct expr_operand<units<rep, fraction, units_tag> > {
+    static constexpr bool lazy = false;
+    using type = expr_constant<units<rep, fraction, units_tag> >;
+    static type make(const units<rep, fraction, units_tag> &u) noexcept {
+        return type{static_cast<typename type::compute>(u.amount())};
+    }
+};
+
+template <typename node>
+struct expr_node_operand {
+    static constexpr bool lazy = true;
+    using type = node;
+    static const type& make(const node &n) noexcept { return n; }
+};
+
+template <typename lhs, typename rhs, bool subtract>
+struct expr_operand<expr_add<lhs, rhs, subtract> >
+    : expr_node_operand<expr_add<lhs, rhs, subtract> > {};
+
+template <typename lhs, typename rhs, bool divide>
+struct expr_operand<expr_multiply<lhs, rhs, divide> >
+    : expr_node_operand<expr_multiply<lhs, rhs, divide> > {};
+
+template <typename node, typename scalar, bool divide>
+struct expr_operand<expr_scalar<node, scalar, divide> >
+    : expr_node_operand<expr_scalar<node, scalar, divide> > {};
+
+template <typename node>
+struct expr_operand<expr_negate<node> >
+    : expr_node_operand<expr_negate<node> > {};
+
+// An owning array would not outlive a lazy expression over a temporary
+template <typename T>
+struct expr_dangles : std::false_type {};
+
+template <typename unit>
+struct expr_dangles<quantity_array<unit> > : std::true_type {};
+
+template <typename T>
+using expr_decay = typename std::decay<T>::type;
+
+template <typename T>
+using expr_node = typename expr_operand<expr_decay<T> >::type;
+
+template <typename T>
+struct is_expr_operand : std::integral_constant<bool,
+    !(expr_dangles<expr_decay<T> >::value &&
+      !std::is_lvalue_reference<T>::value)> {};
+
+// Operands of a binary operator: either may be a constant unit, but one
+// must be lazy, which leaves units op units to the units operators
+template <typename T1, typename T2>
+using enable_expr_binary = typename std::enable_if<
+    (expr_operand<expr_decay<T1> >::lazy ||
+     expr_operand<expr_decay<T2> >::lazy) &&
+    is_expr_operand<T1>::value && is_expr_operand<T2>::value &&
+    std::is_class<expr_node<T1> >::value &&
+    std::is_class<expr_node<T2> >::value>::type;
+
+template <typename T, typename scalar>
+using enable_expr_scalar = typename std::enable_if<
+    expr_operand<expr_decay<T> >::lazy && is_expr_operand<T>::value &&
+    std::is_arithmetic<scalar>::value>::type;
+
+template <typename T>
+expr_node<T> make_expr(const T &operand) noexcept {
+    return expr_operand<expr_decay<T> >::make(operand);
+}
+
+// Folded factors are inexact, so integral results round to nearest rather
+// than truncate a value such as 50.999...
+template <typename to_rep, typename compute>
+to_rep expr_store(compute v, std::true_type) noexcept {
+    return static_cast<to_rep>(std::nearbyint(v));
+}
+
+template <typename to_rep, typename compute>
+to_rep expr_store(compute v, std::false_type) noexcept {
+    return static_cast<to_rep>(v);
+}
+
+constexpr std::size_t expr_block = 16;
+
+// Evaluate n elements of an expression into to_unit in one pass. Element i
+// reads only element i of every range, so out may be one of the inputs.
+// A range overlapping out at an offset is evaluated one element at a time,
+// in order, since the blocks below assume that no store feeds a later load.
+// The node is taken by value so that its pointers are known not to change
+// as out is written, and stay in registers.
+template <typename to_unit, typename node>
+void evaluate_n(const node e, std::size_t n, typename to_unit::rep *out) {
+    using to_rep = typename to_unit::rep;
+    using to_fraction = typename to_unit::fraction;
+    using integral = std::integral_constant<bool, std::is_integral<to_rep>::value>;
+    std::size_t i = 0;
+    const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(out);
+    if (e.overlaps(first, first + n * sizeof(to_rep), sizeof(to_rep))) {
+        for (; i < n; ++i) {
+            out[i] = expr_store<to_rep>(e.template eval<to_fraction>(i),
+                                        integral());
+        }
+        return;
+    }
+    // Fixed width blocks vectorize without a cost model that allows
+    // peeling, as at -O2
+    for (; i + expr_block <= n; i += expr_block) {
+#if defined(__clang__)
+#pragma clang loop vectorize(assume_safety)
+#elif defined(__GNUC__)
+#pragma GCC ivdep
+#endif
+        for (std::size_t j = 0; j < expr_block; ++j) {
+            out[i + j] = expr_store<to_rep>(
+                e.template eval<to_fraction>(i + j), integral());
+        }
+    }
+    for (; i < n; ++i) {
+        out[i] = expr_store<to_rep>(e.template eval<to_fraction>(i), integral());
+    }
+}
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_EXPR_IMPL_H
@@ -0,0 +1,218 @@
+#ifndef UNITS_INSTRUMENT_IMPL_H
+#define UNITS_INSTRUMENT_IMPL_H
+
+// Conversion instrumentation is off unless the build defines
+// UNITS_INSTRUMENT_CONVERSIONS to 1, and then must be on in every
+// translation unit of the program
+#ifndef UNITS_INSTRUMENT_CONVERSIONS
+#define UNITS_INSTRUMENT_CONVERSIONS 0
+#endif
+
+#if UNITS_INSTRUMENT_CONVERSIONS
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+namespace detail {
+
+// Where an implicit conversion happened: the source line of a converting
+// construction, or the return address of a compound assignment, since
+// operators cannot take the defaulted arguments that capture a line
+struct conversion_site {
+    const char *file;
+    unsigned line;
+    const void *address;
+
+    constexpr conversion_site(const char *f = __builtin_FILE(),
+                              unsigned l = __builtin_LINE()) noexcept
+        : file(f), line(l), address(nullptr) {}
+
+    constexpr explicit conversion_site(const void *a) noexcept
+        : file(nullptr), line(0), address(a) {}
+
+    bool operator==(const conversion_site &s) const noexcept {
+        return file == s.file && line == s.line && address == s.address;
+    }
+};
+
+// Name of a type, from the compiler's signature of this function
+template <typename T>
+const char* conversion_type_signature() noexcept {
+    return __PRETTY_FUNCTION__;
+}
+
+// One object per pair of units converted between; its address is the key
+struct conversion_kind {
+    const char *(*from)();
+    const char *(*to)();
+};
+
+template <typename from_unit, typename to_unit>
+struct conversion_kind_of {
+    static const conversion_kind value;
+};
+
+template <typename from_unit, typename to_unit>
+const conversion_kind conversion_kind_of<from_unit, to_unit>::value = {
+    &conversion_type_signature<from_unit>, &conversion_type_signature<to_unit>};
+
+// A counted conversion, as merged for a report
+struct conversion_record {
+    const conversion_kind *kind;
+    conversion_site site;
+    std::uint64_t count;
+};
+
+// Per thread open addressed counters. Only the owning thread writes, so
+// counting is a plain load and store; kind is published last so readers
+// on other threads see a complete slot.
+constexpr std::size_t conversion_slots = 1024;
+
+struct conversion_slot {
+    std::atomic<const conversion_kind*> kind{nullptr};
+    conversion_site site;
+    std::atomic<std::uint64_t> count{0};
+};
+
+struct conversion_table {
+    conversion_slot slots[conversion_slots];
+    std::atomic<std::uint64_t> dropped{0};
+
+    void count(const conversion_kind *kind, const conversion_site &site) noexcept {
+        std::size_t h = reinterpret_cast<std::uintptr_t>(kind) ^
+            reinterpret_cast<std::uintptr_t>(site.file) ^
+            reinterpret_cast<std::uintptr_t>(site.address) ^
+            (std::size_t(site.line) * 0x9e3779b97f4a7c15u);
+        h ^= h >> 17;
+        for (std::size_t probe = 0; probe < conversion_slots; ++probe) {
+            conversion_slot &s = slots[(h + probe) % conversion_slots];
+            const conversion_kind *k = s.kind.load(std::memory_order_relaxed);
+            if (k == nullptr) {
+                s.site = site;
+                s.count.store(1, std::memory_order_relaxed);
+                s.kind.store(kind, std::memory_order_release);
+                return;
+            }
+            if (k == kind && s.site == site) {
+                s.count.store(s.count.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+                return;
+            }
+        }
+        dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    }
+
+    void collect(std::vector<conversion_record> &out) const {
+        for (const conversion_slot &s : slots) {
+            const conversion_kind *k = s.kind.load(std::memory_order_acquire);
+            if (k != nullptr) {
+                out.push_back({k, s.site, s.count.load(std::memory_order_relaxed)});
+            }
+        }
+    }
+
+    void reset() noexcept {
+        for (conversion_slot &s : slots) {
+            s.count.store(0, std::memory_order_relaxed);
+        }
+        dropped.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Defined in units_instrument.h, which is included below
+inline void report_conversions_at_exit();
+
+// Every thread's table, and the counts of threads that have exited. The
+// mutex is taken when a thread first converts and when it exits, and by
+// reports, never while counting.
+struct conversion_registry {
+    std::mutex mutex;
+    std::vector<conversion_table*> live;
+    std::vector<conversion_record> retired;
+    std::uint64_t retired_dropped = 0;
+
+    static conversion_registry& instance() {
+        static conversion_registry registry;
+        return registry;
+    }
+
+    ~conversion_registry() { report_conversions_at_exit(); }
+};
+
+struct conversion_table_owner {
+    conversion_table *table;
+
+    conversion_table_owner() : table(new conversion_table()) {
+        conversion_registry &r = conversion_registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(table);
+    }
+
+    ~conversion_table_owner() {
+        conversion_registry &r = conversion_registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        table->collect(r.retired);
+        r.retired_dropped += table->dropped.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < r.live.size(); ++i) {
+            if (r.live[i] == table) {
+                r.live.erase(r.live.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+        delete table;
+    }
+};
+
+inline conversion_table& thread_conversion_table() {
+    thread_local conversion_table_owner owner;
+    return *owner.table;
+}
+
+// Count a conversion of from into to_unit, unless it happens during
+// constant evaluation
+template <typename to_unit, typename from_unit>
+constexpr void count_conversion(const from_unit&, const conversion_site &site) noexcept {
+    if (!std::is_same<from_unit, to_unit>::value &&
+        !__builtin_is_constant_evaluated()) {
+        thread_conversion_table().count(
+            &conversion_kind_of<from_unit, to_unit>::value, site);
+    }
+}
+
+} // namespace detail
+
+} // namespace units
+
+#define UNITS_CONVERSION_SITE \
+    , ::units::detail::conversion_site units_site_ = ::units::detail::conversion_site()
+#define UNITS_CONVERSION_NOINLINE __attribute__((noinline))
+#define UNITS_COUNT_CONVERSION(to_unit, from) \
+    ::units::detail::count_conversion<to_unit>(from, units_site_)
+#define UNITS_COUNT_CALLER_CONVERSION(to_unit, from) \
+    (__builtin_is_constant_evaluated() ? void() : \
+        ::units::detail::count_conversion<to_unit>( \
+            from, ::units::detail::conversion_site(__builtin_return_address(0))))
+
+// Reports, and the report at exit the registry depends on
+#include "units_instrument.h"
+
+#else
+
+// Disabled: no parameters, attributes or code
+#define UNITS_CONVERSION_SITE
+#define UNITS_CONVERSION_NOINLINE
+#define UNITS_COUNT_CONVERSION(to_unit, from) static_cast<void>(0)
+#define UNITS_COUNT_CALLER_CONVERSION(to_unit, from) static_cast<void>(0)
+
+#endif // UNITS_INSTRUMENT_CONVERSIONS
+
+#endif//UNITS_INSTRUMENT_IMPL_H
@@ -0,0 +1,147 @@
+#ifndef UNITS_PACK_IMPL_H
+#define UNITS_PACK_IMPL_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+// Units
+#include "compact_rep.h"
+#include "detail/units_cast_n_impl.h"
+
+namespace units {
+
+namespace detail {
+
+template <typename compact>
+using pack_kernel = void (*)(const float*, std::size_t, compact*);
+
+template <typename compact>
+using unpack_kernel = void (*)(const compact*, std::size_t, float*);
+
+// Scalar kernels: also the fallback
+template <typename compact>
+inline void pack_n_scalar(const float *in, std::size_t n, compact *out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = compact(in[i]);
+    }
+}
+
+template <typename compact>
+inline void unpack_n_scalar(const compact *in, std::size_t n, float *out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = float(in[i]);
+    }
+}
+
+#if UNITS_X86_DISPATCH
+
+__attribute__((target("avx,f16c")))
+inline void pack_n_x86(const float *in, std::size_t n, float16 *out) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                          _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+    }
+    pack_n_scalar(in + i, n - i, out + i);
+}
+
+__attribute__((target("avx,f16c")))
+inline void unpack_n_x86(const float16 *in, std::size_t n, float *out) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+    unpack_n_scalar(in + i, n - i, out + i);
+}
+
+// Round to nearest even on the upper half, as bfloat16::from_float
+__attribute__((target("avx2")))
+inline void pack_n_x86(const float *in, std::size_t n, bfloat16 *out) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i bias = _mm256_set1_epi32(0x7fff);
+    const __m256i quiet = _mm256_set1_epi32(0x400000);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(in + i);
+        const __m256i f = _mm256_castps_si256(v);
+        const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(f, 16), one);
+        const __m256i rounded = _mm256_add_epi32(f, _mm256_add_epi32(bias, lsb));
+        const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+        const __m256i b = _mm256_srli_epi32(_mm256_blendv_epi8(
+            rounded, _mm256_or_si256(f, quiet), nan), 16);
+        const __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packus_epi32(b, b), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm256_castsi256_si128(packed));
+    }
+    pack_n_scalar(in + i, n - i, out + i);
+}
+
+__attribute__((target("avx2")))
+inline void unpack_n_x86(const bfloat16 *in, std::size_t n, float *out) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_castsi256_ps(
+            _mm256_slli_epi32(_mm256_cvtepu16_epi32(b), 16)));
+    }
+    unpack_n_scalar(in + i, n - i, out + i);
+}
+
+#endif // UNITS_X86_DISPATCH
+
+// CPU feature each kernel needs
+template <typename compact>
+struct pack_feature;
+
+template <>
+struct pack_feature<float16> {
+    static bool supported() {
+#if UNITS_X86_DISPATCH
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#else
+        return false;
+#endif
+    }
+};
+
+template <>
+struct pack_feature<bfloat16> {
+    static bool supported() {
+#if UNITS_X86_DISPATCH
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+};
+
+template <typename compact>
+inline pack_kernel<compact> select_pack_kernel() {
+#if UNITS_X86_DISPATCH
+    if (pack_feature<compact>::supported()) {
+        return static_cast<pack_kernel<compact> >(&pack_n_x86);
+    }
+#endif
+    return &pack_n_scalar<compact>;
+}
+
+template <typename compact>
+inline unpack_kernel<compact> select_unpack_kernel() {
+#if UNITS_X86_DISPATCH
+    if (pack_feature<compact>::supported()) {
+        return static_cast<unpack_kernel<compact> >(&unpack_n_x86);
+    }
+#endif
+    return &unpack_n_scalar<compact>;
+}
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_PACK_IMPL_H
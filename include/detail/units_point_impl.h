@@ -0,0 +1,229 @@
+#ifndef UNITS_POINT_IMPL_H
+#define UNITS_POINT_IMPL_H
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "detail/units_cast_n_impl.h"
+#include "detail/units_cast_policy_impl.h"
+
+namespace units {
+
+namespace detail {
+
+// Conversion between points as to = from * scale + offset, with both
+// folded from the fractions and origins at compile time
+template <typename from_point, typename to_point>
+struct affine_transform {
+    using scale = std::ratio_divide<typename from_point::fraction,
+                                    typename to_point::fraction>;
+    using offset = std::ratio_divide<
+        std::ratio_subtract<typename from_point::origin,
+                            typename to_point::origin>,
+        typename to_point::fraction>;
+};
+
+// x * y + z rounded once, as the fused multiply-add kernels round it.
+// std::fma is not constexpr, so constant evaluation rounds twice, as do
+// floating point reps other than the built in ones.
+template <typename rep>
+constexpr rep fused_multiply_add(rep x, rep y, rep z, std::false_type) {
+    return x * y + z;
+}
+
+template <typename rep>
+constexpr rep fused_multiply_add(rep x, rep y, rep z, std::true_type) {
+#if defined(__GNUC__)
+    return __builtin_is_constant_evaluated() ? x * y + z : std::fma(x, y, z);
+#else
+    return x * y + z;
+#endif
+}
+
+template <typename rep>
+constexpr rep fused_multiply_add(rep x, rep y, rep z) {
+    return fused_multiply_add(x, y, z, std::is_floating_point<rep>());
+}
+
+// units_point_cast implementation: floating point, one fused multiply-add
+template <typename to_point, typename transform, typename common_rep,
+          bool floating = treat_as_floating_point<common_rep>::value>
+struct units_point_cast_impl {
+    template <typename rep>
+    static constexpr typename to_point::rep cast(const rep &v) {
+        using to_rep = typename to_point::rep;
+        return static_cast<to_rep>(fused_multiply_add(
+            static_cast<common_rep>(v),
+            units_scale<common_rep, typename transform::scale>::value,
+            units_scale<common_rep, typename transform::offset>::value));
+    }
+};
+
+// units_point_cast implementation: integers over a common denominator in a
+// wide intermediate, truncated once
+template <typename to_point, typename transform, typename common_rep>
+struct units_point_cast_impl<to_point, transform, common_rep, false> {
+    using scale = typename transform::scale;
+    using offset = typename transform::offset;
+
+    template <typename rep>
+    static constexpr typename to_point::rep cast(const rep &v) {
+        using to_rep = typename to_point::rep;
+        return static_cast<to_rep>(
+            (static_cast<wide_int>(v) * scale::num * offset::den +
+             static_cast<wide_int>(offset::num) * scale::den) /
+            (static_cast<wide_int>(scale::den) * offset::den));
+    }
+};
+
+template <typename rep>
+using scale_offset_kernel = void (*)(const rep*, std::size_t, rep*, rep, rep);
+
+// Scalar kernel: also the fallback. Fused, so that every kernel and
+// units_point_cast round alike.
+template <typename rep>
+inline void scale_offset_n_scalar(const rep *in, std::size_t n, rep *out,
+                                  rep factor, rep offset) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::fma(in[i], factor, offset);
+    }
+}
+
+#if UNITS_X86_DISPATCH
+
+__attribute__((target("avx2,fma")))
+inline void scale_offset_n_avx2(const float *in, std::size_t n, float *out,
+                                float factor, float offset) {
+    const __m256 f = _mm256_set1_ps(factor);
+    const __m256 o = _mm256_set1_ps(offset);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(in + i);
+        __m256 b = _mm256_loadu_ps(in + i + 8);
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(a, f, o));
+        _mm256_storeu_ps(out + i + 8, _mm256_fmadd_ps(b, f, o));
+    }
+    for (; i < n; ++i) {
+        out[i] = __builtin_fmaf(in[i], factor, offset);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+inline void scale_offset_n_avx2(const double *in, std::size_t n, double *out,
+                                double factor, double offset) {
+    const __m256d f = _mm256_set1_pd(factor);
+    const __m256d o = _mm256_set1_pd(offset);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_loadu_pd(in + i);
+        __m256d b = _mm256_loadu_pd(in + i + 4);
+        _mm256_storeu_pd(out + i, _mm256_fmadd_pd(a, f, o));
+        _mm256_storeu_pd(out + i + 4, _mm256_fmadd_pd(b, f, o));
+    }
+    for (; i < n; ++i) {
+        out[i] = __builtin_fma(in[i], factor, offset);
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void scale_offset_n_avx512(const float *in, std::size_t n, float *out,
+                                  float factor, float offset) {
+    const __m512 f = _mm512_set1_ps(factor);
+    const __m512 o = _mm512_set1_ps(offset);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i,
+                         _mm512_fmadd_ps(_mm512_loadu_ps(in + i), f, o));
+    }
+    if (i < n) {
+        const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(out + i, m,
+            _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, in + i), f, o));
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void scale_offset_n_avx512(const double *in, std::size_t n, double *out,
+                                  double factor, double offset) {
+    const __m512d f = _mm512_set1_pd(factor);
+    const __m512d o = _mm512_set1_pd(offset);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i,
+                         _mm512_fmadd_pd(_mm512_loadu_pd(in + i), f, o));
+    }
+    if (i < n) {
+        const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_pd(out + i, m,
+            _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, in + i), f, o));
+    }
+}
+
+#endif // UNITS_X86_DISPATCH
+
+// Pick the widest fused multiply-add kernel the running CPU supports
+template <typename rep>
+inline scale_offset_kernel<rep> select_scale_offset_kernel(std::false_type) {
+    return &scale_offset_n_scalar<rep>;
+}
+
+template <typename rep>
+inline scale_offset_kernel<rep> select_scale_offset_kernel(std::true_type) {
+#if UNITS_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return static_cast<scale_offset_kernel<rep> >(&scale_offset_n_avx512);
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return static_cast<scale_offset_kernel<rep> >(&scale_offset_n_avx2);
+    }
+#endif
+    return &scale_offset_n_scalar<rep>;
+}
+
+// Compute in * factor + offset for n values; in and out may be the same buffer
+template <typename rep>
+inline void scale_offset_n(const rep *in, std::size_t n, rep *out,
+                           rep factor, rep offset) {
+    using simd = std::integral_constant<bool,
+        std::is_same<rep, float>::value || std::is_same<rep, double>::value>;
+    static const scale_offset_kernel<rep> kernel =
+        select_scale_offset_kernel<rep>(simd());
+    kernel(in, n, out, factor, offset);
+}
+
+// units_point_cast_n implementation: general case, one value at a time
+template <typename to_point, typename from_point, bool fold = false>
+struct units_point_cast_n_impl {
+    template <typename from_rep, typename to_rep>
+    static void cast(const from_rep *in, std::size_t n, to_rep *out) {
+        using transform = affine_transform<from_point, to_point>;
+        using common_rep = detail::common_rep<from_rep, to_rep>;
+        using uc = units_point_cast_impl<to_point, transform, common_rep>;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = uc::cast(in[i]);
+        }
+    }
+};
+
+// units_point_cast_n implementation: floating point rep shared by both
+// points, handed to the fused multiply-add kernels
+template <typename to_point, typename from_point>
+struct units_point_cast_n_impl<to_point, from_point, true> {
+    template <typename rep>
+    static void cast(const rep *in, std::size_t n, rep *out) {
+        using transform = affine_transform<from_point, to_point>;
+        scale_offset_n(in, n, out,
+                       units_scale<rep, typename transform::scale>::value,
+                       units_scale<rep, typename transform::offset>::value);
+    }
+};
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_POINT_IMPL_H
@@ -0,0 +1,238 @@
+#ifndef UNITS_TABLE_IMPL_H
+#define UNITS_TABLE_IMPL_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+// Units
+#include "detail/units_cast_n_impl.h"
+
+namespace units {
+
+namespace detail {
+
+// A uniform grid: point i is at (i - offset) / scale on the key axis, and
+// segment i runs from values[i] with slopes[i] per grid step
+template <typename rep>
+struct uniform_grid {
+    const rep *values;
+    const rep *slopes;
+    std::size_t points;
+    rep scale;
+    rep offset;
+};
+
+// Breakpoints in ascending order, and slopes[i] per key unit on segment i
+template <typename rep>
+struct piecewise_grid {
+    const rep *keys;
+    const rep *values;
+    const rep *slopes;
+    std::size_t points;
+};
+
+// Both grids clamp to their end points, so keys outside the table take the
+// first or last value, as does NaN at the low end
+template <typename rep>
+inline rep uniform_lookup(const uniform_grid<rep> &g, rep scale, rep x) noexcept {
+    const rep last = static_cast<rep>(g.points - 1);
+    rep t = x * scale + g.offset;
+    t = !(t > rep(0)) ? rep(0) : (t < last ? t : last);
+    const std::size_t i = std::min(static_cast<std::size_t>(t), g.points - 2);
+    return g.values[i] + (t - static_cast<rep>(i)) * g.slopes[i];
+}
+
+// Branchless bracket search: the same steps for every key, which is what
+// lets the vector kernel search eight keys at once
+template <typename rep>
+inline rep piecewise_lookup(const piecewise_grid<rep> &g, rep x) noexcept {
+    x = !(x > g.keys[0]) ? g.keys[0] :
+        (x < g.keys[g.points - 1] ? x : g.keys[g.points - 1]);
+    std::size_t base = 0;
+    for (std::size_t len = g.points - 1; len > 1; ) {
+        const std::size_t half = len / 2;
+        base = g.keys[base + half] <= x ? base + half : base;
+        len -= half;
+    }
+    return g.values[base] + (x - g.keys[base]) * g.slopes[base];
+}
+
+template <typename rep>
+using uniform_lookup_kernel = void (*)(const uniform_grid<rep>&, rep,
+                                       const rep*, std::size_t, rep*);
+
+template <typename rep>
+using piecewise_lookup_kernel = void (*)(const piecewise_grid<rep>&, rep,
+                                         const rep*, std::size_t, rep*);
+
+// Scalar kernels: also the fallback
+template <typename rep>
+inline void uniform_lookup_n_scalar(const uniform_grid<rep> &g, rep factor,
+                                    const rep *in, std::size_t n, rep *out) {
+    const rep scale = g.scale * factor;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = uniform_lookup(g, scale, in[i]);
+    }
+}
+
+template <typename rep>
+inline void piecewise_lookup_n_scalar(const piecewise_grid<rep> &g, rep factor,
+                                      const rep *in, std::size_t n, rep *out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = piecewise_lookup(g, in[i] * factor);
+    }
+}
+
+#if UNITS_X86_DISPATCH
+
+__attribute__((target("avx2,fma")))
+inline void uniform_lookup_n_avx2(const uniform_grid<float> &g, float factor,
+                                  const float *in, std::size_t n, float *out) {
+    const float scale = g.scale * factor;
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 o = _mm256_set1_ps(g.offset);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 last = _mm256_set1_ps(static_cast<float>(g.points - 1));
+    const __m256i max_index = _mm256_set1_epi32(static_cast<int>(g.points - 2));
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 t = _mm256_fmadd_ps(_mm256_loadu_ps(in + i), s, o);
+        // max returns zero for NaN, as the scalar clamp does
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), last);
+        const __m256i idx = _mm256_min_epi32(_mm256_cvttps_epi32(t), max_index);
+        const __m256 f = _mm256_sub_ps(t, _mm256_cvtepi32_ps(idx));
+        const __m256 v = _mm256_i32gather_ps(g.values, idx, 4);
+        const __m256 d = _mm256_i32gather_ps(g.slopes, idx, 4);
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(f, d, v));
+    }
+    for (; i < n; ++i) {
+        out[i] = uniform_lookup(g, scale, in[i]);
+    }
+}
+
+// Vectors searched together. Each step of the search is a gather whose
+// latency one vector alone would wait out, so four are interleaved.
+constexpr std::size_t lookup_interleave = 4;
+
+__attribute__((target("avx2,fma")))
+inline void piecewise_lookup_n_avx2(const piecewise_grid<float> &g, float factor,
+                                    const float *in, std::size_t n, float *out) {
+    constexpr std::size_t w = lookup_interleave;
+    const __m256 f = _mm256_set1_ps(factor);
+    const __m256 lo = _mm256_set1_ps(g.keys[0]);
+    const __m256 hi = _mm256_set1_ps(g.keys[g.points - 1]);
+    std::size_t i = 0;
+    for (; i + 8 * w <= n; i += 8 * w) {
+        __m256 x[w];
+        __m256i base[w];
+        for (std::size_t j = 0; j < w; ++j) {
+            x[j] = _mm256_mul_ps(_mm256_loadu_ps(in + i + 8 * j), f);
+            x[j] = _mm256_min_ps(_mm256_max_ps(x[j], lo), hi);
+            base[j] = _mm256_setzero_si256();
+        }
+        for (std::size_t len = g.points - 1; len > 1; ) {
+            const std::size_t half = len / 2;
+            const __m256i step = _mm256_set1_epi32(static_cast<int>(half));
+            for (std::size_t j = 0; j < w; ++j) {
+                const __m256i mid = _mm256_add_epi32(base[j], step);
+                const __m256 k = _mm256_i32gather_ps(g.keys, mid, 4);
+                const __m256i le = _mm256_castps_si256(
+                    _mm256_cmp_ps(k, x[j], _CMP_LE_OQ));
+                base[j] = _mm256_blendv_epi8(base[j], mid, le);
+            }
+            len -= half;
+        }
+        for (std::size_t j = 0; j < w; ++j) {
+            const __m256 k = _mm256_i32gather_ps(g.keys, base[j], 4);
+            const __m256 v = _mm256_i32gather_ps(g.values, base[j], 4);
+            const __m256 d = _mm256_i32gather_ps(g.slopes, base[j], 4);
+            _mm256_storeu_ps(out + i + 8 * j,
+                             _mm256_fmadd_ps(_mm256_sub_ps(x[j], k), d, v));
+        }
+    }
+    for (; i < n; ++i) {
+        out[i] = piecewise_lookup(g, in[i] * factor);
+    }
+}
+
+#endif // UNITS_X86_DISPATCH
+
+// Gathers index with 32 bit lanes
+constexpr std::size_t lookup_simd_points =
+    static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)());
+
+inline bool lookup_simd_supported() {
+#if UNITS_X86_DISPATCH
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+template <typename rep>
+inline uniform_lookup_kernel<rep> select_uniform_lookup_kernel(std::false_type) {
+    return &uniform_lookup_n_scalar<rep>;
+}
+
+template <typename rep>
+inline uniform_lookup_kernel<rep> select_uniform_lookup_kernel(std::true_type) {
+#if UNITS_X86_DISPATCH
+    if (lookup_simd_supported()) {
+        return &uniform_lookup_n_avx2;
+    }
+#endif
+    return &uniform_lookup_n_scalar<rep>;
+}
+
+template <typename rep>
+inline piecewise_lookup_kernel<rep> select_piecewise_lookup_kernel(std::false_type) {
+    return &piecewise_lookup_n_scalar<rep>;
+}
+
+template <typename rep>
+inline piecewise_lookup_kernel<rep> select_piecewise_lookup_kernel(std::true_type) {
+#if UNITS_X86_DISPATCH
+    if (lookup_simd_supported()) {
+        return &piecewise_lookup_n_avx2;
+    }
+#endif
+    return &piecewise_lookup_n_scalar<rep>;
+}
+
+// Look up n keys, each first multiplied by factor, with the widest kernel
+// the running CPU supports
+template <typename rep>
+inline void uniform_lookup_n(const uniform_grid<rep> &g, rep factor,
+                             const rep *in, std::size_t n, rep *out) {
+    using simd = std::integral_constant<bool, std::is_same<rep, float>::value>;
+    static const uniform_lookup_kernel<rep> kernel =
+        select_uniform_lookup_kernel<rep>(simd());
+    if (g.points > lookup_simd_points) {
+        uniform_lookup_n_scalar(g, factor, in, n, out);
+        return;
+    }
+    kernel(g, factor, in, n, out);
+}
+
+template <typename rep>
+inline void piecewise_lookup_n(const piecewise_grid<rep> &g, rep factor,
+                               const rep *in, std::size_t n, rep *out) {
+    using simd = std::integral_constant<bool, std::is_same<rep, float>::value>;
+    static const piecewise_lookup_kernel<rep> kernel =
+        select_piecewise_lookup_kernel<rep>(simd());
+    if (g.points > lookup_simd_points) {
+        piecewise_lookup_n_scalar(g, factor, in, n, out);
+        return;
+    }
+    kernel(g, factor, in, n, out);
+}
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_TABLE_IMPL_H
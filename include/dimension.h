@@ -0,0 +1,74 @@
+#ifndef DIMENSION_H
+#define DIMENSION_H
+
+// STL
+#include <ratio>
+#include <type_traits>
+// Units
+#include "units_fwd.h"
+#include "units_traits.h"
+
+namespace units {
+
+namespace detail {
+
+// Exponent vector over the base dimensions
+template <int distance_, int weight_, int time_>
+struct dimension {
+    static constexpr int distance = distance_;
+    static constexpr int weight = weight_;
+    static constexpr int time = time_;
+};
+
+template <typename d1, typename d2>
+using dimension_multiply = dimension<d1::distance + d2::distance,
+                                     d1::weight + d2::weight,
+                                     d1::time + d2::time>;
+
+template <typename d1, typename d2>
+using dimension_divide = dimension<d1::distance - d2::distance,
+                                   d1::weight - d2::weight,
+                                   d1::time - d2::time>;
+
+} // namespace detail
+
+// Map a units tag onto its exponent vector. Base tags specialize this next
+// to their aliases; composite units use the exponent vector as their tag.
+template <typename units_tag>
+struct dimension_of;
+
+template <int distance, int weight, int time>
+struct dimension_of<detail::dimension<distance, weight, time> > {
+    using type = detail::dimension<distance, weight, time>;
+};
+
+// Map an exponent vector back onto its canonical units tag, so that a
+// composite which reduces to a base dimension converts like the base units
+template <typename dimension>
+struct dimension_tag {
+    using type = dimension;
+};
+
+// Composite unit types. The fraction is merged at compile time, so the
+// amount of a product or quotient is the product or quotient of amounts.
+template <typename units1, typename units2>
+using units_multiply = units<
+    detail::common_rep<typename units1::rep, typename units2::rep>,
+    std::ratio_multiply<typename units1::fraction,
+                        typename units2::fraction>,
+    typename dimension_tag<detail::dimension_multiply<
+        typename dimension_of<typename units1::units_tag>::type,
+        typename dimension_of<typename units2::units_tag>::type> >::type>;
+
+template <typename units1, typename units2>
+using units_divide = units<
+    detail::common_rep<typename units1::rep, typename units2::rep>,
+    std::ratio_divide<typename units1::fraction,
+                      typename units2::fraction>,
+    typename dimension_tag<detail::dimension_divide<
+        typename dimension_of<typename units1::units_tag>::type,
+        typename dimension_of<typename units2::units_tag>::type> >::type>;
+
+} // namespace units
+
+#endif//DIMENSION_H
@@ -4,12 +4,12 @@
 // STL
 #include <ratio>
 // Units
+#include "dimension.h"
 #include "units.h"
+#include "units_symbol.h"
 
 namespace units {
 
-inline namespace distance {
-
 namespace detail {
 
 struct distance_tag {};
@@ -19,49 +19,81 @@ using distance = units<rep_, fraction_, distance_tag>;
 
 } // namespace detail
 
+template <>
+struct dimension_of<detail::distance_tag> {
+    using type = detail::dimension<1, 0, 0>;
+};
+
+template <>
+struct dimension_tag<detail::dimension<1, 0, 0> > {
+    using type = detail::distance_tag;
+};
+
+inline namespace distance {
+
+// Fractions are in inches, reduced ahead of time so that naming a unit does
+// not instantiate a chain of std::ratio_multiply
 template <typename rep>
 using inches = detail::distance<rep, std::ratio<1> >;
+// 12 inches
 template <typename rep>
-using feet = detail::distance<
-    rep, std::ratio_multiply<std::ratio<12>,
-                             typename inches<rep>::fraction> >;
+using feet = detail::distance<rep, std::ratio<12> >;
+// 3 feet
 template <typename rep>
-using yards = detail::distance<
-    rep, std::ratio_multiply<std::ratio<3>,
-                             typename feet<rep>::fraction> >;
+using yards = detail::distance<rep, std::ratio<36> >;
+// 1760 yards
 template <typename rep>
-using miles = detail::distance<
-    rep, std::ratio_multiply<std::ratio<1760>,
-                             typename yards<rep>::fraction> >;
+using miles = detail::distance<rep, std::ratio<63360> >;
+// 72913.4 inches
 template <typename rep>
-using nautical_miles = detail::distance<
-    rep, std::ratio_multiply<std::ratio<729134, 10>,
-                             typename inches<rep>::fraction> >;
-
-
+using nautical_miles = detail::distance<rep, std::ratio<364567, 5> >;
+// 10000 / 254 inches
 template <typename rep>
-using meters = detail::distance<
-    rep, std::ratio_multiply<std::ratio<10000, 254>,
-                             typename inches<rep>::fraction> >;
+using meters = detail::distance<rep, std::ratio<5000, 127> >;
+// 1 / 1000000 meters
 template <typename rep>
-using micrometers = detail::distance<
-    rep, std::ratio_multiply<std::micro,
-                             typename meters<rep>::fraction> >;
+using micrometers = detail::distance<rep, std::ratio<1, 25400> >;
+// 1 / 1000 meters
 template <typename rep>
-using millimeters = detail::distance<
-    rep, std::ratio_multiply<std::milli,
-                             typename meters<rep>::fraction> >;
+using millimeters = detail::distance<rep, std::ratio<5, 127> >;
+// 1 / 100 meters
 template <typename rep>
-using centimeters = detail::distance<
-    rep, std::ratio_multiply<std::centi,
-                             typename meters<rep>::fraction> >;
+using centimeters = detail::distance<rep, std::ratio<50, 127> >;
+// 1000 meters
 template <typename rep>
-using kilometers = detail::distance<
-    rep, std::ratio_multiply<std::kilo,
-                             typename meters<rep>::fraction> >;
+using kilometers = detail::distance<rep, std::ratio<5000000, 127> >;
 
 } // namespace distance
 
+// Unit symbols, canonical symbol first
+template <>
+struct units_symbols<detail::distance_tag> {
+    static constexpr symbol_entry table[] = {
+        {"in", inches<int>::fraction::num,
+         inches<int>::fraction::den},
+        {"ft", feet<int>::fraction::num,
+         feet<int>::fraction::den},
+        {"yd", yards<int>::fraction::num,
+         yards<int>::fraction::den},
+        {"mi", miles<int>::fraction::num,
+         miles<int>::fraction::den},
+        {"nmi", nautical_miles<int>::fraction::num,
+         nautical_miles<int>::fraction::den},
+        {"m", meters<int>::fraction::num,
+         meters<int>::fraction::den},
+        {"um", micrometers<int>::fraction::num,
+         micrometers<int>::fraction::den},
+        {"\u00b5m", micrometers<int>::fraction::num,
+         micrometers<int>::fraction::den},
+        {"mm", millimeters<int>::fraction::num,
+         millimeters<int>::fraction::den},
+        {"cm", centimeters<int>::fraction::num,
+         centimeters<int>::fraction::den},
+        {"km", kilometers<int>::fraction::num,
+         kilometers<int>::fraction::den},
+    };
+};
+
 } // namespace units
 
 #endif//DISTANCE_H
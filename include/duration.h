@@ -0,0 +1,75 @@
+#ifndef DURATION_H
+#define DURATION_H
+
+// STL
+#include <ratio>
+// Units
+#include "dimension.h"
+#include "units.h"
+#include "units_symbol.h"
+
+namespace units {
+
+namespace detail {
+
+struct duration_tag {};
+
+template <typename rep_, typename fraction_>
+using duration = units<rep_, fraction_, duration_tag>;
+
+} // namespace detail
+
+template <>
+struct dimension_of<detail::duration_tag> {
+    using type = detail::dimension<0, 0, 1>;
+};
+
+template <>
+struct dimension_tag<detail::dimension<0, 0, 1> > {
+    using type = detail::duration_tag;
+};
+
+inline namespace duration {
+
+// Fractions are in seconds
+template <typename rep>
+using seconds = detail::duration<rep, std::ratio<1> >;
+template <typename rep>
+using nanoseconds = detail::duration<rep, std::nano >;
+template <typename rep>
+using microseconds = detail::duration<rep, std::micro >;
+template <typename rep>
+using milliseconds = detail::duration<rep, std::milli >;
+// 60 seconds
+template <typename rep>
+using minutes = detail::duration<rep, std::ratio<60> >;
+// 60 minutes
+template <typename rep>
+using hours = detail::duration<rep, std::ratio<3600> >;
+
+} // namespace duration
+
+// Unit symbols, canonical symbol first
+template <>
+struct units_symbols<detail::duration_tag> {
+    static constexpr symbol_entry table[] = {
+        {"s", seconds<int>::fraction::num,
+         seconds<int>::fraction::den},
+        {"ns", nanoseconds<int>::fraction::num,
+         nanoseconds<int>::fraction::den},
+        {"us", microseconds<int>::fraction::num,
+         microseconds<int>::fraction::den},
+        {"\u00b5s", microseconds<int>::fraction::num,
+         microseconds<int>::fraction::den},
+        {"ms", milliseconds<int>::fraction::num,
+         milliseconds<int>::fraction::den},
+        {"min", minutes<int>::fraction::num,
+         minutes<int>::fraction::den},
+        {"h", hours<int>::fraction::num,
+         hours<int>::fraction::den},
+    };
+};
+
+} // namespace units
+
+#endif//DURATION_H
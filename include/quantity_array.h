@@ -0,0 +1,221 @@
+#ifndef QUANTITY_ARRAY_H
+#define QUANTITY_ARRAY_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+// Units
+#include "units.h"
+#include "units_cast_n.h"
+
+namespace units {
+
+// Alignment of quantity_array storage, wide enough for any SIMD kernel
+constexpr std::size_t quantity_alignment = 64;
+
+namespace detail {
+
+// Units which can be viewed over a buffer of their rep and back
+template <typename unit>
+struct is_rep_layout : std::integral_constant<bool,
+    is_unit<unit>::value &&
+    std::is_standard_layout<unit>::value &&
+    std::is_trivially_copyable<unit>::value &&
+    sizeof(unit) == sizeof(typename unit::rep) &&
+    alignof(unit) == alignof(typename unit::rep)> {};
+
+} // namespace detail
+
+// Non-owning view of contiguous units. A quantity_span<const U> views
+// read-only data.
+template <typename unit>
+struct quantity_span {
+    using value_type = typename std::remove_const<unit>::type;
+    using rep = typename value_type::rep;
+    using rep_pointer = typename std::conditional<
+        std::is_const<unit>::value, const rep*, rep*>::type;
+    using pointer = unit*;
+    using reference = unit&;
+    using iterator = unit*;
+
+    static_assert(detail::is_rep_layout<value_type>::value,
+                  "units must be laid out as their rep");
+
+    constexpr quantity_span() noexcept = default;
+
+    constexpr quantity_span(pointer data, std::size_t size) noexcept
+        : data_(data), size_(size) {}
+
+    // Adopt a buffer of raw reps without copying
+    quantity_span(rep_pointer data, std::size_t size) noexcept
+        : data_(reinterpret_cast<pointer>(data)), size_(size) {}
+
+    template <typename unit2,
+              typename = typename std::enable_if<
+                  std::is_convertible<unit2*, unit*>::value>::type>
+    constexpr quantity_span(const quantity_span<unit2> &other) noexcept
+        : data_(other.data()), size_(other.size()) {}
+
+    constexpr pointer data() const noexcept { return data_; }
+    rep_pointer raw_data() const noexcept {
+        return reinterpret_cast<rep_pointer>(data_);
+    }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+    constexpr reference operator[](std::size_t i) const noexcept {
+        return data_[i];
+    }
+
+    // Convert the viewed values in place, returning a view of the result
+    template <typename to_unit>
+    quantity_span<to_unit> convert_to() const {
+        static_assert(!std::is_const<unit>::value,
+                      "cannot convert read-only quantities in place");
+        units_cast_in_place<to_unit, value_type>(raw_data(), size_);
+        return quantity_span<to_unit>(
+            reinterpret_cast<typename to_unit::rep*>(raw_data()), size_);
+    }
+
+    // Convert the viewed values into another buffer. Converts as many values
+    // as both spans hold, and returns that count.
+    template <typename to_unit>
+    std::size_t convert_to(quantity_span<to_unit> out) const {
+        const std::size_t n = std::min(size_, out.size());
+        units_cast_n(data_, n, out.data());
+        return n;
+    }
+
+private:
+    pointer data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Owning, aligned, contiguous array of units
+template <typename unit>
+struct quantity_array {
+    using value_type = unit;
+    using rep = typename unit::rep;
+    using iterator = unit*;
+    using const_iterator = const unit*;
+
+    static_assert(detail::is_rep_layout<unit>::value,
+                  "units must be laid out as their rep");
+
+    quantity_array() noexcept = default;
+
+    explicit quantity_array(std::size_t size)
+        : data_(allocate(size)), size_(size) {}
+
+    quantity_array(std::size_t size, const unit &value)
+        : quantity_array(size) {
+        std::fill(begin(), end(), value);
+    }
+
+    quantity_array(const quantity_array &other)
+        : quantity_array(other.size_) {
+        std::copy(other.begin(), other.end(), begin());
+    }
+
+    quantity_array(quantity_array &&other) noexcept
+        : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    quantity_array& operator=(const quantity_array &other) {
+        if (this != &other) {
+            quantity_array(other).swap(*this);
+        }
+        return *this;
+    }
+
+    quantity_array& operator=(quantity_array &&other) noexcept {
+        quantity_array(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~quantity_array() noexcept { deallocate(data_); }
+
+    void swap(quantity_array &other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    unit* data() noexcept { return data_; }
+    const unit* data() const noexcept { return data_; }
+    rep* raw_data() noexcept { return reinterpret_cast<rep*>(data_); }
+    const rep* raw_data() const noexcept {
+        return reinterpret_cast<const rep*>(data_);
+    }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    iterator begin() noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    unit& operator[](std::size_t i) noexcept { return data_[i]; }
+    const unit& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+    quantity_span<unit> span() noexcept { return {data_, size_}; }
+    quantity_span<const unit> span() const noexcept { return {data_, size_}; }
+    operator quantity_span<unit>() noexcept { return span(); }
+    operator quantity_span<const unit>() const noexcept { return span(); }
+
+    // Convert into a new array, leaving this one untouched
+    template <typename to_unit>
+    quantity_array<to_unit> convert_to() const & {
+        quantity_array<to_unit> out(size_);
+        units_cast_n(data_, size_, out.data());
+        return out;
+    }
+
+    // Convert in place, handing the storage over to the result
+    template <typename to_unit>
+    quantity_array<to_unit> convert_to() && {
+        static_assert(std::is_same<typename to_unit::rep, rep>::value,
+                      "in place conversion requires identical reps");
+        units_cast_in_place<to_unit, unit>(raw_data(), size_);
+        quantity_array<to_unit> out;
+        out.data_ = reinterpret_cast<to_unit*>(data_);
+        out.size_ = size_;
+        data_ = nullptr;
+        size_ = 0;
+        return out;
+    }
+
+private:
+    template <typename unit2>
+    friend struct quantity_array;
+
+    static unit* allocate(std::size_t size) {
+        if (size == 0) {
+            return nullptr;
+        }
+        unit *data = static_cast<unit*>(
+            ::operator new(size * sizeof(unit),
+                           std::align_val_t(quantity_alignment)));
+        std::uninitialized_default_construct_n(data, size);
+        return data;
+    }
+
+    static void deallocate(unit *data) noexcept {
+        if (data) {
+            ::operator delete(data, std::align_val_t(quantity_alignment));
+        }
+    }
+
+    unit *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace units
+
+#endif//QUANTITY_ARRAY_H
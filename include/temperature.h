@@ -0,0 +1,60 @@
+#ifndef TEMPERATURE_H
+#define TEMPERATURE_H
+
+// STL
+#include <cstdint>
+#include <ratio>
+// Units
+#include "units.h"
+#include "units_identity.h"
+#include "units_point.h"
+
+namespace units {
+
+namespace detail {
+
+struct temperature_tag {};
+
+template <typename rep_, typename fraction_>
+using temperature = units<rep_, fraction_, temperature_tag>;
+
+} // namespace detail
+
+// Temperature is not a base dimension of the dimension engine, so it has no
+// dimension_of and does not form composite units. It is identified by name.
+template <>
+struct units_tag_identity<detail::temperature_tag> {
+    static constexpr std::uint64_t value =
+        detail::identity_hash(detail::identity_basis, "temperature");
+};
+
+inline namespace temperature {
+
+// Fractions are in kelvin. These are temperature differences.
+template <typename rep>
+using kelvin = detail::temperature<rep, std::ratio<1> >;
+template <typename rep>
+using celsius = detail::temperature<rep, std::ratio<1> >;
+// 5/9 kelvin
+template <typename rep>
+using rankine = detail::temperature<rep, std::ratio<5, 9> >;
+template <typename rep>
+using fahrenheit = detail::temperature<rep, std::ratio<5, 9> >;
+
+// Origins are in kelvin. These are absolute temperatures.
+template <typename rep>
+using kelvin_point = units_point<kelvin<rep> >;
+// 273.15 kelvin
+template <typename rep>
+using celsius_point = units_point<celsius<rep>, std::ratio<27315, 100> >;
+template <typename rep>
+using rankine_point = units_point<rankine<rep> >;
+// 459.67 rankine
+template <typename rep>
+using fahrenheit_point = units_point<fahrenheit<rep>, std::ratio<45967, 180> >;
+
+} // namespace temperature
+
+} // namespace units
+
+#endif//TEMPERATURE_H
@@ -2,14 +2,49 @@
 #define UNITS_H
 
 // STL
+#include <cstdint>
 #include <ratio>
 #include <type_traits>
 // Units
+#include "detail/units_instrument_impl.h"
+#include "dimension.h"
 #include "units_cast.h"
 #include "units_traits.h"
 
 namespace units {
 
+namespace detail {
+
+template <std::intmax_t a, std::intmax_t b>
+struct static_gcd : static_gcd<b, a % b> {};
+
+template <std::intmax_t a>
+struct static_gcd<a, 0> : std::integral_constant<std::intmax_t, a> {};
+
+// The largest fraction both fractions are whole multiples of, so converting
+// either one to it is a single integral multiply
+template <typename frac1, typename frac2>
+using common_units_fraction = std::ratio<
+    static_gcd<frac1::num, frac2::num>::value,
+    (frac1::den / static_gcd<frac1::den, frac2::den>::value) * frac2::den>;
+
+} // namespace detail
+
+} // namespace units
+
+// Like std::chrono::duration, like units have a common type that both
+// convert to without loss of precision
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+struct std::common_type<units::units<rep1, frac1, ut>,
+                        units::units<rep2, frac2, ut> > {
+    using type = units::units<units::detail::common_rep<rep1, rep2>,
+                              units::detail::common_units_fraction<frac1, frac2>,
+                              ut>;
+};
+
+namespace units {
+
 // units template
 template <typename rep_, typename fraction_, typename units_tag_>
 struct units {
@@ -18,63 +53,70 @@ struct units {
     using units_tag = units_tag_;
 
     constexpr units() = default;
-    units(const units&) = default;
-    units(units&&) = default;
-    units& operator=(const units&) = default;
-    units& operator=(units&&) = default;
+    constexpr units(const units&) = default;
+    constexpr units(units&&) = default;
+    constexpr units& operator=(const units&) = default;
+    constexpr units& operator=(units&&) = default;
     ~units() noexcept = default;
 
     template <typename rep2,
               typename = typename std::enable_if<
                   std::is_convertible<rep2, rep>::value &&
-                  (std::is_floating_point<rep>::value ||
-                   !std::is_floating_point<rep2>::value)>::type>
-    constexpr explicit units(const rep2& v)
+                  (treat_as_floating_point<rep>::value ||
+                   !treat_as_floating_point<rep2>::value)>::type>
+    constexpr explicit units(const rep2& v) noexcept
         : value_(static_cast<rep>(v)) {}
 
     template <typename rep2, typename frac2,
               typename = typename std::enable_if<
-                  std::is_floating_point<rep>::value ||
+                  treat_as_floating_point<rep>::value ||
                   (std::ratio_multiply<frac2, fraction>::den == 1 &&
-                   !std::is_floating_point<rep2>::value)>::type>
-    constexpr units(const units<rep2, frac2, units_tag> &other)
-        : value_(static_cast<rep>(units_cast<units>(other).amount())) {}
+                   !treat_as_floating_point<rep2>::value)>::type>
+    constexpr units(const units<rep2, frac2, units_tag> &other
+                    UNITS_CONVERSION_SITE) noexcept
+        : value_(static_cast<rep>(units_cast<units>(other).amount())) {
+        UNITS_COUNT_CONVERSION(units, other);
+    }
 
-    constexpr rep amount() const { return value_; }
+    constexpr rep amount() const noexcept { return value_; }
 
-    constexpr units operator+() const { return *this; }
-    constexpr units operator-() const { return units(-value_); }
+    constexpr units operator+() const noexcept { return *this; }
+    constexpr units operator-() const noexcept { return units(-value_); }
 
     // Addition and subtraction of units result in the same unit
     template <typename rep2, typename frac2>
-    units& operator+=(const units<rep2, frac2, units_tag> &u2) {
+    UNITS_CONVERSION_NOINLINE constexpr units& operator+=(
+        const units<rep2, frac2, units_tag> &u2) noexcept {
+        UNITS_COUNT_CALLER_CONVERSION(units, u2);
         value_ += units_cast<units>(u2).amount();
         return *this;
     }
 
     template <typename rep2, typename frac2>
-    units& operator-=(const units<rep2, frac2, units_tag> &u2) {
+    UNITS_CONVERSION_NOINLINE constexpr units& operator-=(
+        const units<rep2, frac2, units_tag> &u2) noexcept {
+        UNITS_COUNT_CALLER_CONVERSION(units, u2);
         value_ -= units_cast<units>(u2).amount();
         return *this;
     }
 
     // Scalar adjustment of units?
-    units& operator+=(const rep &c) {
+    constexpr units& operator+=(const rep &c) noexcept {
         value_ += c;
         return *this;
     }
 
-    units& operator-=(const rep &c) {
+    constexpr units& operator-=(const rep &c) noexcept {
         value_ -= c;
         return *this;
     }
 
-    units& operator*=(const rep &c) {
+    constexpr units& operator*=(const rep &c) noexcept {
         value_ *= c;
         return *this;
     }
 
-    units& operator/=(const rep &c) {
+    constexpr units& operator/=(const rep &c) noexcept {
         value_ /= c;
         return *this;
     }
@@ -83,84 +125,238 @@ private:
     rep value_;
 };
 
-// Basic comparison operators for units
-template <typename rep, typename frac, typename ut>
-bool operator==(const units<rep, frac, ut> &ub1,
-                const units<rep, frac, ut> &ub2) noexcept {
-    return ub1.amount() == ub2.amount();
+namespace detail {
+
+// Whether two units with integral reps scale to their common fraction in
+// the wide intermediate for every value, and whether their sums and
+// differences fit it too. Without a 128 bit type, 64 bit reps may not.
+template <typename unit1, typename unit2,
+          bool integral = !treat_as_floating_point<typename unit1::rep>::value &&
+                          !treat_as_floating_point<typename unit2::rep>::value>
+struct wide_scales {
+    static constexpr bool compare_fits = false;
+    static constexpr bool sum_fits = false;
+};
+
+template <typename unit1, typename unit2>
+struct wide_scales<unit1, unit2, true> {
+    using common_fraction = common_units_fraction<typename unit1::fraction,
+                                                  typename unit2::fraction>;
+    using scale1 = std::ratio_divide<typename unit1::fraction, common_fraction>;
+    using scale2 = std::ratio_divide<typename unit2::fraction, common_fraction>;
+    using range1 = wide_scale_range<typename unit1::rep, scale1>;
+    using range2 = wide_scale_range<typename unit2::rep, scale2>;
+    static constexpr bool compare_fits =
+        range1::intermediate_fits && range2::intermediate_fits;
+    static constexpr bool sum_fits = compare_fits &&
+        range1::max <= wide_int_max - range2::max &&
+        range1::max <= wide_int_max + range2::min &&
+        range1::min >= -wide_int_max - range2::min &&
+        range1::min >= -wide_int_max + range2::max;
+};
+
+// Mixed unit comparison. Integral reps are scaled to their common fraction
+// by compile time integer factors in a wide intermediate, so the result is
+// exact for every value, where that intermediate holds every scaled value;
+// anything else compares in the common unit.
+template <typename unit1, typename unit2,
+          bool wide = wide_scales<unit1, unit2>::compare_fits>
+struct units_compare {
+    using common = typename std::common_type<unit1, unit2>::type;
+
+    static constexpr bool equal(const unit1 &u1, const unit2 &u2) noexcept {
+        return units_cast<common>(u1).amount() == units_cast<common>(u2).amount();
+    }
+
+    static constexpr bool less(const unit1 &u1, const unit2 &u2) noexcept {
+        return units_cast<common>(u1).amount() < units_cast<common>(u2).amount();
+    }
+};
+
+template <typename unit1, typename unit2>
+struct units_compare<unit1, unit2, true> {
+    using common_fraction = typename wide_scales<unit1, unit2>::common_fraction;
+    using scale1 = typename wide_scales<unit1, unit2>::scale1;
+    using scale2 = typename wide_scales<unit1, unit2>::scale2;
+
+    static constexpr wide_int scaled1(const unit1 &u) noexcept {
+        return static_cast<wide_int>(u.amount()) * scale1::num;
+    }
+
+    static constexpr wide_int scaled2(const unit2 &u) noexcept {
+        return static_cast<wide_int>(u.amount()) * scale2::num;
+    }
+
+    static constexpr bool equal(const unit1 &u1, const unit2 &u2) noexcept {
+        return scaled1(u1) == scaled2(u2);
+    }
+
+    static constexpr bool less(const unit1 &u1, const unit2 &u2) noexcept {
+        return scaled1(u1) < scaled2(u2);
+    }
+};
+
+// Mixed unit addition and subtraction. Integral reps are scaled and summed
+// in the wide intermediate of units_compare, where it holds every sum, so
+// the result is exact whenever it fits the common rep, even where an
+// operand scaled alone would not; anything else sums in the common unit.
+template <typename unit1, typename unit2,
+          bool wide = wide_scales<unit1, unit2>::sum_fits>
+struct units_sum {
+    using common = typename std::common_type<unit1, unit2>::type;
+
+    static constexpr common plus(const unit1 &u1, const unit2 &u2) noexcept {
+        return common(units_cast<common>(u1).amount() +
+                      units_cast<common>(u2).amount());
+    }
+
+    static constexpr common minus(const unit1 &u1, const unit2 &u2) noexcept {
+        return common(units_cast<common>(u1).amount() -
+                      units_cast<common>(u2).amount());
+    }
+};
+
+template <typename unit1, typename unit2>
+struct units_sum<unit1, unit2, true> {
+    using common = typename std::common_type<unit1, unit2>::type;
+    using compare = units_compare<unit1, unit2, true>;
+    using rep = typename common::rep;
+    static_assert(std::is_same<typename common::fraction,
+                               typename compare::common_fraction>::value,
+                  "mixed sums must scale into the common unit");
+
+    static constexpr common plus(const unit1 &u1, const unit2 &u2) noexcept {
+        return common(static_cast<rep>(compare::scaled1(u1) +
+                                       compare::scaled2(u2)));
+    }
+
+    static constexpr common minus(const unit1 &u1, const unit2 &u2) noexcept {
+        return common(static_cast<rep>(compare::scaled1(u1) -
+                                       compare::scaled2(u2)));
+    }
+};
+
+} // namespace detail
+
+// Basic comparison operators for units. Mixed units compare in their
+// common unit, which is exact for integral reps
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+constexpr bool operator==(const units<rep1, frac1, ut> &ub1,
+                const units<rep2, frac2, ut> &ub2) noexcept {
+    return detail::units_compare<units<rep1, frac1, ut>,
+                                 units<rep2, frac2, ut> >::equal(ub1, ub2);
 }
 
-template <typename rep, typename frac, typename ut>
-bool operator!=(const units<rep, frac, ut> &ub1,
-                const units<rep, frac, ut> &ub2) noexcept {
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+constexpr bool operator!=(const units<rep1, frac1, ut> &ub1,
+                const units<rep2, frac2, ut> &ub2) noexcept {
     return !(ub1 == ub2);
 }
 
-template <typename rep, typename frac, typename ut>
-bool operator>=(const units<rep, frac, ut> &ub1,
-                const units<rep, frac, ut> &ub2) noexcept {
-    return ub1.amount() >= ub2.amount();
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+constexpr bool operator<(const units<rep1, frac1, ut> &ub1,
+               const units<rep2, frac2, ut> &ub2) noexcept {
+    return detail::units_compare<units<rep1, frac1, ut>,
+                                 units<rep2, frac2, ut> >::less(ub1, ub2);
 }
 
-template <typename rep, typename frac, typename ut>
-bool operator<=(const units<rep, frac, ut> &ub1,
-                const units<rep, frac, ut> &ub2) noexcept {
-    return ub1.amount() <= ub2.amount();
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+constexpr bool operator>(const units<rep1, frac1, ut> &ub1,
+               const units<rep2, frac2, ut> &ub2) noexcept {
+    return ub2 < ub1;
 }
 
-template <typename rep, typename frac, typename ut>
-bool operator>(const units<rep, frac, ut> &ub1,
-               const units<rep, frac, ut> &ub2) noexcept {
-    return ub1.amount() > ub2.amount();
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+constexpr bool operator<=(const units<rep1, frac1, ut> &ub1,
+                const units<rep2, frac2, ut> &ub2) noexcept {
+    return !(ub2 < ub1);
 }
 
-template <typename rep, typename frac, typename ut>
-bool operator<(const units<rep, frac, ut> &ub1,
-               const units<rep, frac, ut> &ub2) noexcept {
-    return ub1.amount() < ub2.amount();
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+constexpr bool operator>=(const units<rep1, frac1, ut> &ub1,
+                const units<rep2, frac2, ut> &ub2) noexcept {
+    return !(ub1 < ub2);
 }
 
 // Unit scalar math operations
 template <typename rep, typename frac, typename ut>
-units<rep, frac, ut> operator+(
+constexpr units<rep, frac, ut> operator+(
     units<rep, frac, ut> ub1, const rep &s) noexcept {
     return ub1 += s;
 }
 
 template <typename rep, typename frac, typename ut>
-units<rep, frac, ut> operator-(
+constexpr units<rep, frac, ut> operator-(
     units<rep, frac, ut> ub1, const rep &s) noexcept {
     return ub1 -= s;
 }
 
 template <typename rep, typename frac, typename ut>
-units<rep, frac, ut> operator*(
+constexpr units<rep, frac, ut> operator*(
     units<rep, frac, ut> ub1, const rep &s) noexcept {
     return ub1 *= s;
 }
 
 template <typename rep, typename frac, typename ut>
-units<rep, frac, ut> operator/(
+constexpr units<rep, frac, ut> operator/(
     units<rep, frac, ut> ub1, const rep &s) noexcept {
     return ub1 /= s;
 }
 
-// Unit addition and subtraction
-template <typename rep, typename frac, typename ut>
-units<rep, frac, ut> operator+(
-    units<rep, frac, ut> ub1, const units<rep, frac, ut> &ub2) noexcept {
-    return ub1 += ub2;
+// Unit addition and subtraction result in the common unit of the operands
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+UNITS_CONVERSION_NOINLINE constexpr typename std::common_type<
+    units<rep1, frac1, ut>, units<rep2, frac2, ut> >::type
+operator+(const units<rep1, frac1, ut> &ub1,
+          const units<rep2, frac2, ut> &ub2) noexcept {
+    using sum = detail::units_sum<units<rep1, frac1, ut>, units<rep2, frac2, ut> >;
+    UNITS_COUNT_CALLER_CONVERSION(typename sum::common, ub1);
+    UNITS_COUNT_CALLER_CONVERSION(typename sum::common, ub2);
+    return sum::plus(ub1, ub2);
 }
 
-template <typename rep, typename frac, typename ut>
-units<rep, frac, ut> operator-(
-    units<rep, frac, ut> ub1, const units<rep, frac, ut> &ub2) noexcept {
-    return ub1 -= ub2;
+template <typename rep1, typename frac1, typename rep2, typename frac2,
+          typename ut>
+UNITS_CONVERSION_NOINLINE constexpr typename std::common_type<
+    units<rep1, frac1, ut>, units<rep2, frac2, ut> >::type
+operator-(const units<rep1, frac1, ut> &ub1,
+          const units<rep2, frac2, ut> &ub2) noexcept {
+    using sum = detail::units_sum<units<rep1, frac1, ut>, units<rep2, frac2, ut> >;
+    UNITS_COUNT_CALLER_CONVERSION(typename sum::common, ub1);
+    UNITS_COUNT_CALLER_CONVERSION(typename sum::common, ub2);
+    return sum::minus(ub1, ub2);
+}
+
+// Multiplying or dividing units results in a composite unit whose
+// fraction and dimension are computed at compile time
+template <typename rep, typename frac1, typename ut1,
+          typename frac2, typename ut2>
+constexpr units_multiply<units<rep, frac1, ut1>, units<rep, frac2, ut2> >
+operator*(const units<rep, frac1, ut1> &ub1,
+          const units<rep, frac2, ut2> &ub2) noexcept {
+    return units_multiply<units<rep, frac1, ut1>, units<rep, frac2, ut2> >(
+        ub1.amount() * ub2.amount());
+}
+
+template <typename rep, typename frac1, typename ut1,
+          typename frac2, typename ut2>
+constexpr units_divide<units<rep, frac1, ut1>, units<rep, frac2, ut2> >
+operator/(const units<rep, frac1, ut1> &ub1,
+          const units<rep, frac2, ut2> &ub2) noexcept {
+    return units_divide<units<rep, frac1, ut1>, units<rep, frac2, ut2> >(
+        ub1.amount() / ub2.amount());
 }
 
 // Dividing an operator by a like unit results in a scalar ratio
 template <typename rep, typename frac1, typename frac2, typename ut>
-rep operator/(const units<rep, frac1, ut> &ub1,
+constexpr rep operator/(const units<rep, frac1, ut> &ub1,
               const units<rep, frac2, ut> &ub2) noexcept {
     return ub1.amount() / units_cast<units<rep, frac1, ut> >(ub2).amount();
 }
@@ -0,0 +1,243 @@
+#ifndef UNITS_ATOMIC_H
+#define UNITS_ATOMIC_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+// Units
+#include "quantity_array.h"
+#include "units.h"
+#include "units_cast.h"
+#include "units_traits.h"
+
+namespace units {
+
+// An atomic quantity of a single unit. Stores and arithmetic accept any
+// convertible unit, which is cast to this unit before the atomic operation,
+// so only the raw rep ever crosses threads. Lock-free whenever
+// std::atomic<rep> is.
+template <typename unit_>
+class atomic_units {
+    static_assert(is_unit<unit_>::value, "atomic_units must be over a unit");
+
+public:
+    using unit = unit_;
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+
+    static constexpr bool is_always_lock_free =
+        std::atomic<rep>::is_always_lock_free;
+
+    atomic_units() noexcept : value_(rep()) {}
+    constexpr atomic_units(const unit &u) noexcept : value_(u.amount()) {}
+    atomic_units(const atomic_units&) = delete;
+    atomic_units& operator=(const atomic_units&) = delete;
+
+    bool is_lock_free() const noexcept { return value_.is_lock_free(); }
+
+    unit load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return unit(value_.load(order));
+    }
+
+    operator unit() const noexcept { return load(); }
+
+    template <typename rep2, typename frac2>
+    void store(const units<rep2, frac2, units_tag> &u,
+               std::memory_order order = std::memory_order_seq_cst) noexcept {
+        value_.store(cast(u), order);
+    }
+
+    template <typename rep2, typename frac2>
+    unit exchange(const units<rep2, frac2, units_tag> &u,
+                  std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return unit(value_.exchange(cast(u), order));
+    }
+
+    bool compare_exchange_weak(
+        unit &expected, const unit &desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        rep e = expected.amount();
+        const bool ok = value_.compare_exchange_weak(e, desired.amount(), order);
+        expected = unit(e);
+        return ok;
+    }
+
+    bool compare_exchange_strong(
+        unit &expected, const unit &desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        rep e = expected.amount();
+        const bool ok = value_.compare_exchange_strong(e, desired.amount(), order);
+        expected = unit(e);
+        return ok;
+    }
+
+    // Atomically add or subtract, returning the previous value
+    template <typename rep2, typename frac2>
+    unit fetch_add(const units<rep2, frac2, units_tag> &u,
+                   std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return unit(add(cast(u), order, integral()));
+    }
+
+    template <typename rep2, typename frac2>
+    unit fetch_sub(const units<rep2, frac2, units_tag> &u,
+                   std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return unit(add(negate(cast(u)), order, integral()));
+    }
+
+    template <typename rep2, typename frac2>
+    unit operator=(const units<rep2, frac2, units_tag> &u) noexcept {
+        store(u);
+        return load();
+    }
+
+    // Compound assignment returns the new value, as std::atomic does
+    template <typename rep2, typename frac2>
+    unit operator+=(const units<rep2, frac2, units_tag> &u) noexcept {
+        return fetch_add(u) + unit(cast(u));
+    }
+
+    template <typename rep2, typename frac2>
+    unit operator-=(const units<rep2, frac2, units_tag> &u) noexcept {
+        return fetch_sub(u) - unit(cast(u));
+    }
+
+private:
+    using compute = typename compute_rep<rep>::type;
+    using integral = std::integral_constant<bool, std::is_integral<rep>::value>;
+
+    template <typename rep2, typename frac2>
+    static constexpr rep cast(const units<rep2, frac2, units_tag> &u) noexcept {
+        static_assert(is_unit_convertible<unit, units<rep2, frac2, units_tag> >::value,
+                      "units must be convertible in order to cast");
+        return units_cast<unit>(u).amount();
+    }
+
+    static rep negate(const rep &v) noexcept {
+        return static_cast<rep>(-static_cast<compute>(v));
+    }
+
+    // Integral reps use the hardware add
+    rep add(const rep &delta, std::memory_order order, std::true_type) noexcept {
+        return value_.fetch_add(delta, order);
+    }
+
+    // Everything else adds in its compute type inside a compare exchange loop
+    rep add(const rep &delta, std::memory_order order, std::false_type) noexcept {
+        rep old = value_.load(std::memory_order_relaxed);
+        while (!value_.compare_exchange_weak(
+                   old, static_cast<rep>(static_cast<compute>(old) +
+                                         static_cast<compute>(delta)),
+                   order, std::memory_order_relaxed)) {
+        }
+        return old;
+    }
+
+    std::atomic<rep> value_;
+};
+
+namespace detail {
+
+// Shard used by the calling thread. Threads are numbered as they first
+// touch any sharded_units, so neighbouring threads land on different shards.
+inline std::size_t thread_shard() noexcept {
+    static std::atomic<std::size_t> next(0);
+    thread_local const std::size_t shard =
+        next.fetch_add(1, std::memory_order_relaxed);
+    return shard;
+}
+
+// One cache line per shard, so writers on different cores never share one
+template <typename unit>
+struct alignas(quantity_alignment) units_shard {
+    atomic_units<unit> value;
+};
+
+} // namespace detail
+
+// A total updated by many threads at once. Each thread adds to its own
+// cache line with relaxed atomics, and reads merge the shards, so writes
+// scale with the number of cores. A read is a sum of shards loaded one
+// after another: exact once writers are done, and otherwise some total the
+// counter held while the read was in progress.
+template <typename unit_>
+class sharded_units {
+public:
+    using unit = unit_;
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+
+    // One shard per hardware thread unless told otherwise
+    explicit sharded_units(std::size_t shards =
+                               std::thread::hardware_concurrency())
+        : shards_(shards ? shards : 1) {}
+
+    sharded_units(const sharded_units&) = delete;
+    sharded_units& operator=(const sharded_units&) = delete;
+
+    std::size_t shard_count() const noexcept { return shards_.size(); }
+
+    template <typename rep2, typename frac2>
+    void add(const units<rep2, frac2, units_tag> &u) noexcept {
+        local().fetch_add(u, std::memory_order_relaxed);
+    }
+
+    template <typename rep2, typename frac2>
+    void sub(const units<rep2, frac2, units_tag> &u) noexcept {
+        local().fetch_sub(u, std::memory_order_relaxed);
+    }
+
+    template <typename rep2, typename frac2>
+    sharded_units& operator+=(const units<rep2, frac2, units_tag> &u) noexcept {
+        add(u);
+        return *this;
+    }
+
+    template <typename rep2, typename frac2>
+    sharded_units& operator-=(const units<rep2, frac2, units_tag> &u) noexcept {
+        sub(u);
+        return *this;
+    }
+
+    // Merge the shards
+    unit load() const noexcept {
+        accumulator total = 0;
+        for (const auto &s : shards_) {
+            total += static_cast<accumulator>(
+                s.value.load(std::memory_order_acquire).amount());
+        }
+        return unit(static_cast<rep>(total));
+    }
+
+    operator unit() const noexcept { return load(); }
+
+    // Merge the shards and zero them, returning the total taken out
+    unit reset() noexcept {
+        accumulator total = 0;
+        for (auto &s : shards_) {
+            total += static_cast<accumulator>(
+                s.value.exchange(unit(rep()), std::memory_order_acq_rel).amount());
+        }
+        return unit(static_cast<rep>(total));
+    }
+
+private:
+    // Floating point merges in at least double, as the reductions do
+    using accumulator = typename std::conditional<
+        treat_as_floating_point<rep>::value,
+        detail::common_rep<rep, double>, rep>::type;
+
+    atomic_units<unit>& local() noexcept {
+        return shards_[detail::thread_shard() % shards_.size()].value;
+    }
+
+    std::vector<detail::units_shard<unit> > shards_;
+};
+
+} // namespace units
+
+#endif//UNITS_ATOMIC_H
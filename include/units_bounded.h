@@ -0,0 +1,356 @@
+#ifndef UNITS_BOUNDED_H
+#define UNITS_BOUNDED_H
+
+// STL
+#include <ratio>
+#include <system_error>
+#include <type_traits>
+// Units
+#include "detail/units_bounded_impl.h"
+#include "dimension.h"
+#include "units.h"
+
+namespace units {
+
+// A unit whose amount is known to lie within compile time bounds, given as
+// std::ratios of the unit: weights that cannot be negative, or distances
+// within the range of a sensor. Values from untrusted data are checked
+// once, by make_bounded or clamp, and from then on the bounds travel with
+// the type. Sums, differences, products and quotients of bounded units,
+// and units_cast to other fractions, are bounded by interval arithmetic at
+// compile time, so no result needs checking again. amount() tells the
+// compiler the bounds hold, so that it can prove checks downstream.
+//
+// Integral reps round declared bounds inward and derived bounds outward,
+// and the bounds of every result must fit its rep. Sums and differences
+// scale their operands in the wide intermediate where it holds them, and
+// otherwise the scaled bounds of each operand must fit the common rep too.
+// Those checks at compile time rule out overflow. Floating point results
+// are clamped into their bounds, which only absorbs rounding.
+template <typename unit_, typename lower_, typename upper_>
+class bounded_units {
+    static_assert(is_unit<unit_>::value, "bounded_units must be over a unit");
+    static_assert(std::is_arithmetic<typename unit_::rep>::value,
+                  "bounded_units need an arithmetic rep");
+    using bounds = detail::bounds_of<typename unit_::rep, lower_, upper_>;
+
+public:
+    using unit = unit_;
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+    using lower = typename bounds::lower_inward;
+    using upper = typename bounds::upper_inward;
+
+    static_assert(!std::ratio_less<upper, lower>::value,
+                  "bounds must not be empty");
+    static_assert(detail::bounds_fit_rep<rep, lower, upper>::value,
+                  "bounds must fit the rep");
+
+    // The bound nearest zero
+    constexpr bounded_units() noexcept
+        : value_(detail::bounds_clamp(rep(0), lower_value(), upper_value())) {}
+
+    // Bounded units whose bounds, in this unit, lie within these widen
+    // implicitly, counted as a conversion where the widening is written
+    template <typename unit2, typename lower2, typename upper2,
+              typename cast = detail::bounds_cast<unit, typename unit2::fraction,
+                                                  lower2, upper2>,
+              typename = typename std::enable_if<
+                  std::is_convertible<unit2, unit>::value &&
+                  !std::ratio_less<typename cast::lower_type, lower>::value &&
+                  !std::ratio_less<upper, typename cast::upper_type>::value>::type>
+    constexpr bounded_units(const bounded_units<unit2, lower2, upper2> &other
+                            UNITS_CONVERSION_SITE) noexcept
+        : bounded_units(detail::bounds_proven(), units_cast<unit>(other.value())) {
+        UNITS_COUNT_CONVERSION(unit, other.value());
+    }
+
+    // For values already proven within the bounds; floating point values
+    // are clamped to absorb rounding
+    constexpr bounded_units(detail::bounds_proven, const unit &u) noexcept
+        : value_(prove(u.amount(), treat_as_floating_point<rep>())) {}
+
+    static constexpr bounded_units min() noexcept {
+        return bounded_units(detail::bounds_proven(), unit(lower_value()));
+    }
+
+    static constexpr bounded_units max() noexcept {
+        return bounded_units(detail::bounds_proven(), unit(upper_value()));
+    }
+
+    // A constant, checked at compile time
+    template <typename value>
+    static constexpr bounded_units constant() noexcept {
+        static_assert(!std::ratio_less<value, lower>::value &&
+                      !std::ratio_less<upper, value>::value,
+                      "constant must lie within the bounds");
+        return bounded_units(detail::bounds_proven(),
+                             unit(detail::bound_value<rep, value>::value));
+    }
+
+    // Whether u lies within the bounds, compared exactly for integral reps.
+    // NaN does not.
+    template <typename rep2, typename frac2>
+    static constexpr bool contains(const units<rep2, frac2, units_tag> &u) noexcept {
+        return u == u && !(u < min().value()) && !(max().value() < u);
+    }
+
+    // u clamped into the bounds, NaN to the lower bound
+    template <typename rep2, typename frac2>
+    static constexpr bounded_units clamp(const units<rep2, frac2, units_tag> &u) noexcept {
+        return !(u > min().value()) ? min() :
+               !(u < max().value()) ? max() :
+               bounded_units(detail::bounds_proven(), units_cast<unit>(u));
+    }
+
+    constexpr rep amount() const noexcept {
+        return detail::assume_within(value_, lower_value(), upper_value());
+    }
+
+    constexpr unit value() const noexcept { return unit(amount()); }
+    constexpr operator unit() const noexcept { return value(); }
+
+    constexpr bounded_units operator+() const noexcept { return *this; }
+
+private:
+    static constexpr rep lower_value() noexcept {
+        return detail::bound_value<rep, lower>::value;
+    }
+
+    static constexpr rep upper_value() noexcept {
+        return detail::bound_value<rep, upper>::value;
+    }
+
+    static constexpr rep prove(rep v, std::true_type) noexcept {
+        return detail::bounds_clamp(v, lower_value(), upper_value());
+    }
+
+    static constexpr rep prove(rep v, std::false_type) noexcept { return v; }
+
+    rep value_;
+};
+
+template <typename T>
+struct is_bounded_units : std::false_type {};
+
+template <typename unit, typename lower, typename upper>
+struct is_bounded_units<bounded_units<unit, lower, upper> > : std::true_type {};
+
+// Result of checking untrusted data against bounds: on failure, ec is
+// std::errc::result_out_of_range, or std::errc::invalid_argument for NaN,
+// and value is the input clamped into the bounds
+template <typename bounded>
+struct bounded_result {
+    bounded value;
+    std::errc ec;
+};
+
+template <typename bounded, typename rep, typename fraction, typename units_tag>
+constexpr typename std::enable_if<is_bounded_units<bounded>::value,
+                                  bounded_result<bounded> >::type
+make_bounded(const units<rep, fraction, units_tag> &u) noexcept {
+    return {bounded::clamp(u),
+            bounded::contains(u) ? std::errc() :
+            u == u ? std::errc::result_out_of_range : std::errc::invalid_argument};
+}
+
+// units_cast of bounded units carries the bounds into to_unit
+template <typename to_unit, typename unit, typename lower, typename upper,
+          typename cast = detail::bounds_cast<to_unit, typename unit::fraction,
+                                              lower, upper> >
+constexpr bounded_units<to_unit, typename cast::lower_type, typename cast::upper_type>
+units_cast(const bounded_units<unit, lower, upper> &b) noexcept {
+    return {detail::bounds_proven(), units_cast<to_unit>(b.value())};
+}
+
+template <typename unit, typename lower, typename upper>
+constexpr bounded_units<unit, std::ratio_subtract<std::ratio<0>, upper>,
+                        std::ratio_subtract<std::ratio<0>, lower> >
+operator-(const bounded_units<unit, lower, upper> &b) noexcept {
+    return {detail::bounds_proven(), -b.value()};
+}
+
+namespace detail {
+
+// Bounds of a sum or difference, in the common unit of the operands. The
+// operands are summed by units_sum. Where its integral sums scale them in
+// the wide intermediate, their scaled bounds need not fit the common rep;
+// where they are cast into the common unit first, they must.
+template <typename b1, typename b2, bool subtract>
+struct bounded_sum {
+    using sum = units_sum<typename b1::unit, typename b2::unit>;
+    using unit = typename sum::common;
+    using cast1 = bounds_cast<unit, typename b1::fraction,
+                              typename b1::lower, typename b1::upper>;
+    using cast2 = bounds_cast<unit, typename b2::fraction,
+                              typename b2::lower, typename b2::upper>;
+    static_assert(wide_scales<typename b1::unit, typename b2::unit>::sum_fits ||
+                  (bounds_fit_rep<typename unit::rep, typename cast1::lower_type,
+                                  typename cast1::upper_type>::value &&
+                   bounds_fit_rep<typename unit::rep, typename cast2::lower_type,
+                                  typename cast2::upper_type>::value),
+                  "operands of bounded sums must scale within the common rep");
+    using type = typename std::conditional<subtract,
+        bounded_units<unit,
+                      std::ratio_subtract<typename cast1::lower_type,
+                                          typename cast2::upper_type>,
+                      std::ratio_subtract<typename cast1::upper_type,
+                                          typename cast2::lower_type> >,
+        bounded_units<unit,
+                      std::ratio_add<typename cast1::lower_type,
+                                     typename cast2::lower_type>,
+                      std::ratio_add<typename cast1::upper_type,
+                                     typename cast2::upper_type> > >::type;
+};
+
+template <bool divide>
+struct bounds_op {
+    template <typename r1, typename r2>
+    using type = std::ratio_multiply<r1, r2>;
+};
+
+template <>
+struct bounds_op<true> {
+    template <typename r1, typename r2>
+    using type = std::ratio_divide<r1, r2>;
+};
+
+// Bounds of a product or quotient, in its composite unit
+template <typename b1, typename b2, bool divide>
+struct bounded_product {
+    static_assert(!divide || std::ratio_less<std::ratio<0>, typename b2::lower>::value ||
+                  std::ratio_less<typename b2::upper, std::ratio<0> >::value,
+                  "the bounds of a divisor must exclude zero");
+    using unit = typename std::conditional<divide,
+        units_divide<typename b1::unit, typename b2::unit>,
+        units_multiply<typename b1::unit, typename b2::unit> >::type;
+    using op = bounds_op<divide>;
+    using corners = bounds_of_corners<
+        typename unit::rep,
+        typename op::template type<typename b1::lower, typename b2::lower>,
+        typename op::template type<typename b1::lower, typename b2::upper>,
+        typename op::template type<typename b1::upper, typename b2::lower>,
+        typename op::template type<typename b1::upper, typename b2::upper> >;
+    using type = bounded_units<unit, typename corners::lower_type,
+                               typename corners::upper_type>;
+};
+
+} // namespace detail
+
+template <typename unit1, typename lower1, typename upper1,
+          typename unit2, typename lower2, typename upper2,
+          typename result = detail::bounded_sum<
+              bounded_units<unit1, lower1, upper1>,
+              bounded_units<unit2, lower2, upper2>, false> >
+constexpr typename result::type
+operator+(const bounded_units<unit1, lower1, upper1> &b1,
+          const bounded_units<unit2, lower2, upper2> &b2) noexcept {
+    return {detail::bounds_proven(), result::sum::plus(b1.value(), b2.value())};
+}
+
+template <typename unit1, typename lower1, typename upper1,
+          typename unit2, typename lower2, typename upper2,
+          typename result = detail::bounded_sum<
+              bounded_units<unit1, lower1, upper1>,
+              bounded_units<unit2, lower2, upper2>, true> >
+constexpr typename result::type
+operator-(const bounded_units<unit1, lower1, upper1> &b1,
+          const bounded_units<unit2, lower2, upper2> &b2) noexcept {
+    return {detail::bounds_proven(), result::sum::minus(b1.value(), b2.value())};
+}
+
+template <typename unit1, typename lower1, typename upper1,
+          typename unit2, typename lower2, typename upper2,
+          typename result = typename detail::bounded_product<
+              bounded_units<unit1, lower1, upper1>,
+              bounded_units<unit2, lower2, upper2>, false>::type>
+constexpr result operator*(const bounded_units<unit1, lower1, upper1> &b1,
+                           const bounded_units<unit2, lower2, upper2> &b2) noexcept {
+    return {detail::bounds_proven(), b1.value() * b2.value()};
+}
+
+// Quotients of units of different dimensions are bounded composite units;
+// of like units, a plain scalar ratio
+template <typename unit1, typename lower1, typename upper1,
+          typename unit2, typename lower2, typename upper2,
+          typename = typename std::enable_if<
+              !std::is_same<typename unit1::units_tag,
+                            typename unit2::units_tag>::value>::type,
+          typename result = typename detail::bounded_product<
+              bounded_units<unit1, lower1, upper1>,
+              bounded_units<unit2, lower2, upper2>, true>::type>
+constexpr result operator/(const bounded_units<unit1, lower1, upper1> &b1,
+                           const bounded_units<unit2, lower2, upper2> &b2) noexcept {
+    return {detail::bounds_proven(), b1.value() / b2.value()};
+}
+
+template <typename unit1, typename lower1, typename upper1,
+          typename unit2, typename lower2, typename upper2,
+          typename = typename std::enable_if<
+              std::is_same<typename unit1::units_tag,
+                           typename unit2::units_tag>::value>::type>
+constexpr auto operator/(const bounded_units<unit1, lower1, upper1> &b1,
+                         const bounded_units<unit2, lower2, upper2> &b2) noexcept
+    -> decltype(b1.value() / b2.value()) {
+    return b1.value() / b2.value();
+}
+
+namespace detail {
+
+template <typename T>
+constexpr const T& bounded_value(const T &u) noexcept { return u; }
+
+template <typename unit, typename lower, typename upper>
+constexpr unit bounded_value(const bounded_units<unit, lower, upper> &b) noexcept {
+    return b.value();
+}
+
+// Comparisons with at least one bounded operand, and otherwise units
+template <typename T1, typename T2>
+using enable_bounded_compare = typename std::enable_if<
+    (is_bounded_units<T1>::value || is_bounded_units<T2>::value) &&
+    (is_bounded_units<T1>::value || is_unit<T1>::value) &&
+    (is_bounded_units<T2>::value || is_unit<T2>::value)>::type;
+
+} // namespace detail
+
+template <typename T1, typename T2,
+          typename = detail::enable_bounded_compare<T1, T2> >
+constexpr bool operator==(const T1 &a, const T2 &b) noexcept {
+    return detail::bounded_value(a) == detail::bounded_value(b);
+}
+
+template <typename T1, typename T2,
+          typename = detail::enable_bounded_compare<T1, T2> >
+constexpr bool operator!=(const T1 &a, const T2 &b) noexcept {
+    return detail::bounded_value(a) != detail::bounded_value(b);
+}
+
+template <typename T1, typename T2,
+          typename = detail::enable_bounded_compare<T1, T2> >
+constexpr bool operator<(const T1 &a, const T2 &b) noexcept {
+    return detail::bounded_value(a) < detail::bounded_value(b);
+}
+
+template <typename T1, typename T2,
+          typename = detail::enable_bounded_compare<T1, T2> >
+constexpr bool operator<=(const T1 &a, const T2 &b) noexcept {
+    return detail::bounded_value(a) <= detail::bounded_value(b);
+}
+
+template <typename T1, typename T2,
+          typename = detail::enable_bounded_compare<T1, T2> >
+constexpr bool operator>(const T1 &a, const T2 &b) noexcept {
+    return detail::bounded_value(a) > detail::bounded_value(b);
+}
+
+template <typename T1, typename T2,
+          typename = detail::enable_bounded_compare<T1, T2> >
+constexpr bool operator>=(const T1 &a, const T2 &b) noexcept {
+    return detail::bounded_value(a) >= detail::bounded_value(b);
+}
+
+} // namespace units
+
+#endif//UNITS_BOUNDED_H
@@ -5,26 +5,55 @@
 #include <ratio>
 #include <type_traits>
 // Units
-#include "detail/units_cast_impl.h"
+#include "detail/units_cast_policy_impl.h"
+#include "units_cast_policy.h"
 
 namespace units {
 
-// units_cast
-template <typename to_unit, typename rep, typename fraction, typename units_tag>
-constexpr typename std::enable_if<is_unit<to_unit>::value, to_unit>::type
-units_cast(const units<rep, fraction, units_tag> &u) {
+// units_cast with the arithmetic chosen by a cast_policy
+template <typename to_unit, typename policy,
+          typename rep, typename fraction, typename units_tag>
+constexpr typename std::enable_if<is_unit<to_unit>::value &&
+                                  is_cast_policy<policy>::value, to_unit>::type
+units_cast(const units<rep, fraction, units_tag> &u) noexcept {
     static_assert(is_unit_convertible<to_unit, units<rep, fraction, units_tag> >::value,
                   "units must be convertible in order to cast");
     using to_rep = typename to_unit::rep;
     using to_fraction = typename to_unit::fraction;
     using common_fraction = std::ratio_divide<fraction, to_fraction>;
-    using common_rep = typename std::common_type<to_rep, rep>::type;
-    using uc = detail::units_cast_impl<to_unit, common_fraction, common_rep,
-        common_fraction::num == 1, common_fraction::den == 1>;
+    using common_rep = detail::common_rep<to_rep, rep>;
+    using uc = detail::units_cast_policy_impl<policy, to_unit, common_fraction,
+                                              common_rep>;
 
     return uc::cast(u);
 }
 
+// units_cast
+template <typename to_unit, typename rep, typename fraction, typename units_tag>
+constexpr typename std::enable_if<is_unit<to_unit>::value, to_unit>::type
+units_cast(const units<rep, fraction, units_tag> &u) noexcept {
+    return units_cast<to_unit, cast_policy::automatic>(u);
+}
+
+// Rounding casts between integral units, as their std::chrono namesakes
+template <typename to_unit, typename rep, typename fraction, typename units_tag>
+constexpr typename std::enable_if<is_unit<to_unit>::value, to_unit>::type
+floor(const units<rep, fraction, units_tag> &u) noexcept {
+    return units_cast<to_unit, cast_policy::rounded<rounding::floor> >(u);
+}
+
+template <typename to_unit, typename rep, typename fraction, typename units_tag>
+constexpr typename std::enable_if<is_unit<to_unit>::value, to_unit>::type
+ceil(const units<rep, fraction, units_tag> &u) noexcept {
+    return units_cast<to_unit, cast_policy::rounded<rounding::ceil> >(u);
+}
+
+template <typename to_unit, typename rep, typename fraction, typename units_tag>
+constexpr typename std::enable_if<is_unit<to_unit>::value, to_unit>::type
+round(const units<rep, fraction, units_tag> &u) noexcept {
+    return units_cast<to_unit, cast_policy::rounded<rounding::nearest> >(u);
+}
+
 } // namespace units
 
 #endif//UNITS_CAST_H
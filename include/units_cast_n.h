@@ -0,0 +1,62 @@
+#ifndef UNITS_CAST_N_H
+#define UNITS_CAST_N_H
+
+// STL
+#include <cstddef>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "detail/units_cast_n_impl.h"
+#include "units.h"
+
+namespace units {
+
+// units_cast_n: convert count raw reps of from_unit at in into to_unit reps
+// at out. in and out may be the same buffer.
+template <typename to_unit, typename from_unit>
+typename std::enable_if<is_unit<to_unit>::value && is_unit<from_unit>::value>::type
+units_cast_n(const typename from_unit::rep *in, std::size_t count,
+             typename to_unit::rep *out) {
+    static_assert(is_unit_convertible<to_unit, from_unit>::value,
+                  "units must be convertible in order to cast");
+    using to_rep = typename to_unit::rep;
+    using from_rep = typename from_unit::rep;
+    using common_fraction = std::ratio_divide<typename from_unit::fraction,
+                                              typename to_unit::fraction>;
+    using uc = detail::units_cast_n_impl<to_unit, from_unit, common_fraction,
+        std::is_same<to_rep, from_rep>::value &&
+        std::is_floating_point<to_rep>::value>;
+
+    uc::cast(in, count, out);
+}
+
+// units_cast_n over units values
+template <typename to_unit, typename rep, typename fraction, typename units_tag>
+typename std::enable_if<is_unit<to_unit>::value>::type
+units_cast_n(const units<rep, fraction, units_tag> *in, std::size_t count,
+             to_unit *out) {
+    using from_unit = units<rep, fraction, units_tag>;
+    static_assert(std::is_standard_layout<from_unit>::value &&
+                  sizeof(from_unit) == sizeof(rep) &&
+                  std::is_standard_layout<to_unit>::value &&
+                  sizeof(to_unit) == sizeof(typename to_unit::rep),
+                  "units must be laid out as their rep");
+    units_cast_n<to_unit, from_unit>(
+        reinterpret_cast<const rep*>(in), count,
+        reinterpret_cast<typename to_unit::rep*>(out));
+}
+
+// units_cast_in_place: convert count raw reps of from_unit at data into
+// to_unit reps, overwriting them
+template <typename to_unit, typename from_unit>
+typename std::enable_if<is_unit<to_unit>::value && is_unit<from_unit>::value>::type
+units_cast_in_place(typename from_unit::rep *data, std::size_t count) {
+    static_assert(std::is_same<typename to_unit::rep,
+                               typename from_unit::rep>::value,
+                  "in place conversion requires identical reps");
+    units_cast_n<to_unit, from_unit>(data, count, data);
+}
+
+} // namespace units
+
+#endif//UNITS_CAST_N_H
@@ -0,0 +1,66 @@
+#ifndef UNITS_CAST_POLICY_H
+#define UNITS_CAST_POLICY_H
+
+// STL
+#include <type_traits>
+
+namespace units {
+
+// Arithmetic used by units_cast when the fraction is not unity
+namespace cast_policy {
+
+// Fastest policy which stays correct for the rep: fused for floating point,
+// integers through a wide intermediate so scaling cannot overflow midway
+struct automatic {};
+
+// Scale by a single precomputed factor: one multiply
+struct fused {};
+
+// Integers scale through a 128 bit intermediate, and the cast only compiles
+// if no value of the source rep can overflow the target rep. Floating point
+// scales in long double and rounds once.
+struct exact {};
+
+// Integers scale through a 128 bit intermediate and clamp to the range of
+// the target rep. Floating point clamps to the finite range of the target.
+struct saturating {};
+
+// Integer scaling with a defined rounding mode, see rounding below
+template <typename rounding_mode>
+struct rounded {};
+
+} // namespace cast_policy
+
+// Rounding modes for cast_policy::rounded. Integers are scaled with integer
+// arithmetic only, and the cast only compiles if no value of the source rep
+// can overflow the target rep.
+namespace rounding {
+
+// Toward zero, as integer division
+struct truncate {};
+// To the nearest value, ties to even as std::chrono::round
+struct nearest {};
+// Toward negative infinity
+struct floor {};
+// Toward positive infinity
+struct ceil {};
+
+} // namespace rounding
+
+template <typename T>
+struct is_cast_policy : std::false_type {};
+
+template <>
+struct is_cast_policy<cast_policy::automatic> : std::true_type {};
+template <>
+struct is_cast_policy<cast_policy::fused> : std::true_type {};
+template <>
+struct is_cast_policy<cast_policy::exact> : std::true_type {};
+template <>
+struct is_cast_policy<cast_policy::saturating> : std::true_type {};
+template <typename rounding_mode>
+struct is_cast_policy<cast_policy::rounded<rounding_mode> > : std::true_type {};
+
+} // namespace units
+
+#endif//UNITS_CAST_POLICY_H
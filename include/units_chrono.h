@@ -0,0 +1,70 @@
+#ifndef UNITS_CHRONO_H
+#define UNITS_CHRONO_H
+
+// STL
+#include <chrono>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "dimension.h"
+#include "duration.h"
+#include "units.h"
+
+namespace units {
+
+// A std::chrono::duration is a duration unit with the same rep and period,
+// so converting between the two never scales
+template <typename rep, typename period>
+constexpr detail::duration<rep, period> from_chrono(
+    const std::chrono::duration<rep, period> &d) noexcept {
+    return detail::duration<rep, period>(d.count());
+}
+
+template <typename rep, typename fraction>
+constexpr std::chrono::duration<rep, fraction> to_chrono(
+    const detail::duration<rep, fraction> &u) noexcept {
+    return std::chrono::duration<rep, fraction>(u.amount());
+}
+
+// Rates and products with a std::chrono::duration. As with two units, the
+// fraction of the result is merged at compile time and only the amounts
+// are multiplied or divided.
+template <typename rep, typename frac, typename ut,
+          typename rep2, typename period>
+constexpr units_divide<units<rep, frac, ut>, detail::duration<rep2, period> >
+operator/(const units<rep, frac, ut> &u,
+          const std::chrono::duration<rep2, period> &d) noexcept {
+    using result = units_divide<units<rep, frac, ut>,
+                                detail::duration<rep2, period> >;
+    using common_rep = typename result::rep;
+    return result(static_cast<common_rep>(u.amount()) /
+                  static_cast<common_rep>(d.count()));
+}
+
+template <typename rep, typename frac, typename ut,
+          typename rep2, typename period>
+constexpr units_multiply<units<rep, frac, ut>, detail::duration<rep2, period> >
+operator*(const units<rep, frac, ut> &u,
+          const std::chrono::duration<rep2, period> &d) noexcept {
+    using result = units_multiply<units<rep, frac, ut>,
+                                  detail::duration<rep2, period> >;
+    using common_rep = typename result::rep;
+    return result(static_cast<common_rep>(u.amount()) *
+                  static_cast<common_rep>(d.count()));
+}
+
+template <typename rep, typename period,
+          typename rep2, typename frac, typename ut>
+constexpr units_multiply<detail::duration<rep, period>, units<rep2, frac, ut> >
+operator*(const std::chrono::duration<rep, period> &d,
+          const units<rep2, frac, ut> &u) noexcept {
+    using result = units_multiply<detail::duration<rep, period>,
+                                  units<rep2, frac, ut> >;
+    using common_rep = typename result::rep;
+    return result(static_cast<common_rep>(d.count()) *
+                  static_cast<common_rep>(u.amount()));
+}
+
+} // namespace units
+
+#endif//UNITS_CHRONO_H
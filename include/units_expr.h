@@ -0,0 +1,121 @@
+#ifndef UNITS_EXPR_H
+#define UNITS_EXPR_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+// Units
+#include "detail/units_expr_impl.h"
+#include "quantity_array.h"
+#include "units.h"
+
+namespace units {
+
+// Lazy arithmetic over ranges of units. Adding, subtracting, multiplying or
+// dividing quantity_spans and quantity_arrays, with each other, with single
+// units or with scalars, builds an expression rather than an array. Nothing
+// is computed until evaluate(), which makes one pass over the inputs with
+// every conversion factor folded into a per-operand constant at compile
+// time, and no temporary arrays.
+//
+// Dimensions are checked as for units: only like units add, and products
+// and quotients are composite units. Expressions hold pointers into their
+// ranges, so they must not outlive them; temporary quantity_arrays are
+// refused as operands. Ranges of different lengths use their common length.
+// Integral reps compute in double, and integral results round to nearest.
+
+// The unit an expression evaluates in when no other is asked for: the
+// common unit of sums, the composite unit of products
+template <typename expr>
+using expr_unit = units<typename detail::expr_node<expr>::compute,
+                        typename detail::expr_node<expr>::fraction,
+                        typename detail::expr_node<expr>::units_tag>;
+
+template <typename T1, typename T2, typename = detail::enable_expr_binary<T1, T2> >
+detail::expr_add<detail::expr_node<T1>, detail::expr_node<T2>, false>
+operator+(T1 &&a, T2 &&b) noexcept {
+    return {detail::make_expr(a), detail::make_expr(b)};
+}
+
+template <typename T1, typename T2, typename = detail::enable_expr_binary<T1, T2> >
+detail::expr_add<detail::expr_node<T1>, detail::expr_node<T2>, true>
+operator-(T1 &&a, T2 &&b) noexcept {
+    return {detail::make_expr(a), detail::make_expr(b)};
+}
+
+template <typename T1, typename T2, typename = detail::enable_expr_binary<T1, T2> >
+detail::expr_multiply<detail::expr_node<T1>, detail::expr_node<T2>, false>
+operator*(T1 &&a, T2 &&b) noexcept {
+    return {detail::make_expr(a), detail::make_expr(b)};
+}
+
+template <typename T1, typename T2, typename = detail::enable_expr_binary<T1, T2> >
+detail::expr_multiply<detail::expr_node<T1>, detail::expr_node<T2>, true>
+operator/(T1 &&a, T2 &&b) noexcept {
+    return {detail::make_expr(a), detail::make_expr(b)};
+}
+
+template <typename T, typename scalar,
+          typename = detail::enable_expr_scalar<T, scalar> >
+detail::expr_scalar<detail::expr_node<T>, scalar, false>
+operator*(T &&a, scalar s) noexcept {
+    return {detail::make_expr(a),
+            static_cast<typename detail::expr_scalar<detail::expr_node<T>, scalar,
+                                                     false>::compute>(s)};
+}
+
+template <typename T, typename scalar,
+          typename = detail::enable_expr_scalar<T, scalar> >
+detail::expr_scalar<detail::expr_node<T>, scalar, false>
+operator*(scalar s, T &&a) noexcept {
+    return {detail::make_expr(a),
+            static_cast<typename detail::expr_scalar<detail::expr_node<T>, scalar,
+                                                     false>::compute>(s)};
+}
+
+template <typename T, typename scalar,
+          typename = detail::enable_expr_scalar<T, scalar> >
+detail::expr_scalar<detail::expr_node<T>, scalar, true>
+operator/(T &&a, scalar s) noexcept {
+    return {detail::make_expr(a),
+            static_cast<typename detail::expr_scalar<detail::expr_node<T>, scalar,
+                                                     true>::compute>(s)};
+}
+
+template <typename T, typename = detail::enable_expr_scalar<T, int> >
+detail::expr_negate<detail::expr_node<T> > operator-(T &&a) noexcept {
+    return {detail::make_expr(a)};
+}
+
+// Evaluate an expression into out, converting to its unit, and return the
+// number of elements written: the shorter of out and the expression.
+// out may be one of the expression's own ranges. A range overlapping out at
+// an offset is read as out is written, one element at a time in order.
+template <typename expr, typename unit>
+std::size_t evaluate(const expr &e, quantity_span<unit> out) {
+    using node = detail::expr_node<expr>;
+    static_assert(std::is_same<typename node::units_tag,
+                               typename unit::units_tag>::value,
+                  "units must have the same dimension to be assigned");
+    const node &n = detail::make_expr(e);
+    const std::size_t count = std::min(n.size(), out.size());
+    detail::evaluate_n<unit>(n, count, out.raw_data());
+    return count;
+}
+
+// Evaluate an expression into a new array, in to_unit or its own unit
+template <typename to_unit = void, typename expr>
+quantity_array<typename std::conditional<std::is_void<to_unit>::value,
+                                         expr_unit<expr>, to_unit>::type>
+evaluate(const expr &e) {
+    using result = typename std::conditional<std::is_void<to_unit>::value,
+                                             expr_unit<expr>, to_unit>::type;
+    quantity_array<result> out(detail::make_expr(e).size());
+    evaluate(e, out.span());
+    return out;
+}
+
+} // namespace units
+
+#endif//UNITS_EXPR_H
@@ -0,0 +1,338 @@
+#ifndef UNITS_FORMAT_H
+#define UNITS_FORMAT_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <system_error>
+#include <type_traits>
+#if __has_include(<format>)
+#include <format>
+#endif
+// Units
+#include "detail/units_cast_policy_impl.h"
+#include "dimension.h"
+#include "units.h"
+#include "units_pair.h"
+#include "units_symbol.h"
+
+namespace units {
+
+// Canonical symbol of a unit, resolved at compile time
+template <typename unit>
+struct units_symbol {
+    using symbols = units_symbols<typename unit::units_tag>;
+
+    static constexpr int find() {
+        for (std::size_t i = 0; i < std::size(symbols::table); ++i) {
+            if (symbols::table[i].num == unit::fraction::num &&
+                symbols::table[i].den == unit::fraction::den) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    static constexpr int index = find();
+    static_assert(index >= 0, "unit has no symbol");
+
+    static constexpr const char *value = symbols::table[index].symbol;
+    static constexpr std::size_t length = detail::symbol_length(value);
+};
+
+namespace detail {
+
+template <typename units_operator>
+struct operator_symbol;
+
+template <typename rep>
+struct operator_symbol<std::multiplies<rep> > {
+    static constexpr char value = '*';
+};
+
+template <typename rep>
+struct operator_symbol<std::divides<rep> > {
+    static constexpr char value = '/';
+};
+
+} // namespace detail
+
+namespace detail {
+
+// Symbols a base dimension can contribute to a composite symbol. A base
+// dimension the composite lacks contributes one empty symbol of fraction 1.
+template <int distance, int weight, int time, int power>
+struct base_symbols {
+    using symbols = units_symbols<typename dimension_tag<
+        dimension<distance, weight, time> >::type>;
+    static constexpr const symbol_entry *table = symbols::table;
+    static constexpr std::size_t size = std::size(symbols::table);
+};
+
+template <int distance, int weight, int time>
+struct base_symbols<distance, weight, time, 0> {
+    static constexpr symbol_entry none[] = {{"", 1, 1}};
+    static constexpr const symbol_entry *table = none;
+    static constexpr std::size_t size = 1;
+};
+
+// a * b, or 0 where it would overflow. Fractions are positive, so 0 is
+// free to mean no product.
+constexpr wide_int symbol_multiply(wide_int a, wide_int b) {
+    return a == 0 || b == 0 || a > wide_int_max / b ? 0 : a * b;
+}
+
+constexpr wide_int symbol_power(wide_int a, int power) {
+    wide_int p = 1;
+    for (int i = 0; i < power; ++i) {
+        p = symbol_multiply(p, a);
+    }
+    return p;
+}
+
+// Append s, and ^power above 1, at out[n]. A null out only counts.
+constexpr std::size_t symbol_append(char *out, std::size_t n, const char *s,
+                                    int power = 1) {
+    for (; *s != '\0'; ++s, ++n) {
+        if (out) {
+            out[n] = *s;
+        }
+    }
+    if (power > 1) {
+        char digits[12] = {};
+        int count = 0;
+        for (; power > 0; power /= 10) {
+            digits[count++] = static_cast<char>('0' + power % 10);
+        }
+        if (out) {
+            out[n] = '^';
+        }
+        ++n;
+        while (count > 0) {
+            if (out) {
+                out[n] = digits[count - 1];
+            }
+            --count;
+            ++n;
+        }
+    }
+    return n;
+}
+
+// Symbol of a composite unit: the base symbols raised to the composite's
+// exponents, such as st/in or m/s^2. The first combination of base symbols,
+// in table order, whose fractions make up the composite's fraction is used.
+template <typename dimension, typename fraction>
+struct composite_symbol {
+    using distance = base_symbols<1, 0, 0, dimension::distance>;
+    using weight = base_symbols<0, 1, 0, dimension::weight>;
+    using time = base_symbols<0, 0, 1, dimension::time>;
+
+    static constexpr int powers[] = {dimension::distance, dimension::weight,
+                                     dimension::time};
+
+    static constexpr bool matches(const symbol_entry *const (&bases)[3]) {
+        // Cross multiplied: the bases' numerator times fraction::den
+        // against their denominator times fraction::num
+        wide_int num = fraction::den;
+        wide_int den = fraction::num;
+        for (std::size_t b = 0; b < 3; ++b) {
+            const int p = powers[b] < 0 ? -powers[b] : powers[b];
+            const std::intmax_t above = powers[b] < 0 ? bases[b]->den : bases[b]->num;
+            const std::intmax_t below = powers[b] < 0 ? bases[b]->num : bases[b]->den;
+            num = symbol_multiply(num, symbol_power(above, p));
+            den = symbol_multiply(den, symbol_power(below, p));
+        }
+        return num != 0 && num == den;
+    }
+
+    static constexpr std::array<int, 3> find() {
+        for (std::size_t i = 0; i < distance::size; ++i) {
+            for (std::size_t j = 0; j < weight::size; ++j) {
+                for (std::size_t k = 0; k < time::size; ++k) {
+                    const symbol_entry *const bases[3] = {
+                        &distance::table[i], &weight::table[j], &time::table[k]};
+                    if (matches(bases)) {
+                        return {{static_cast<int>(i), static_cast<int>(j),
+                                 static_cast<int>(k)}};
+                    }
+                }
+            }
+        }
+        return {{-1, -1, -1}};
+    }
+
+    static constexpr std::array<int, 3> index = find();
+    static_assert(dimension::distance != 0 || dimension::weight != 0 ||
+                  dimension::time != 0,
+                  "dimensionless units have no symbol");
+    static_assert(index[0] >= 0,
+                  "composite unit has no symbol: no combination of base unit "
+                  "symbols makes up its fraction");
+
+    // Positive powers, or 1 if there are none, then / and negative powers
+    static constexpr std::size_t render(char *out) {
+        const char *symbols[3] = {distance::table[index[0]].symbol,
+                                  weight::table[index[1]].symbol,
+                                  time::table[index[2]].symbol};
+        std::size_t n = 0;
+        bool first = true;
+        for (std::size_t b = 0; b < 3; ++b) {
+            if (powers[b] > 0) {
+                n = symbol_append(out, n, first ? "" : "*");
+                n = symbol_append(out, n, symbols[b], powers[b]);
+                first = false;
+            }
+        }
+        if (first) {
+            n = symbol_append(out, n, "1");
+        }
+        first = true;
+        for (std::size_t b = 0; b < 3; ++b) {
+            if (powers[b] < 0) {
+                n = symbol_append(out, n, first ? "/" : "*");
+                n = symbol_append(out, n, symbols[b], -powers[b]);
+                first = false;
+            }
+        }
+        return n;
+    }
+
+    static constexpr std::size_t length = render(nullptr);
+
+    static constexpr std::array<char, length + 1> make() {
+        std::array<char, length + 1> s{};
+        render(s.data());
+        return s;
+    }
+
+    static constexpr std::array<char, length + 1> storage = make();
+    static constexpr const char *value = storage.data();
+};
+
+} // namespace detail
+
+// Composite units, the product or quotient of units, are written with the
+// symbols of their base units
+template <typename rep, typename fraction, int distance, int weight, int time>
+struct units_symbol<units<rep, fraction, detail::dimension<distance, weight, time> > >
+    : detail::composite_symbol<detail::dimension<distance, weight, time>,
+                               fraction> {};
+
+// A units_pair is written as its two symbols joined by its operator
+template <typename units1, typename units2, typename units_operator>
+struct units_symbol<units_pair<units1, units2, units_operator> > {
+    using symbol1 = units_symbol<units1>;
+    using symbol2 = units_symbol<units2>;
+    static constexpr std::size_t length = symbol1::length + 1 + symbol2::length;
+
+    static constexpr std::array<char, length + 1> make() {
+        std::array<char, length + 1> s{};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < symbol1::length; ++i) {
+            s[n++] = symbol1::value[i];
+        }
+        s[n++] = detail::operator_symbol<units_operator>::value;
+        for (std::size_t i = 0; i < symbol2::length; ++i) {
+            s[n++] = symbol2::value[i];
+        }
+        return s;
+    }
+
+    static constexpr std::array<char, length + 1> storage = make();
+    static constexpr const char *value = storage.data();
+};
+
+// A units_pair without an operator in its type could hold either the
+// product or the quotient, so it has no symbol of its own
+template <typename units1, typename units2>
+struct units_symbol<units_pair<units1, units2, void> > {
+    static_assert(!std::is_same<units1, units1>::value,
+                  "a units_pair without an operator has no symbol; "
+                  "name the operator in its type to format it");
+};
+
+namespace detail {
+
+// Append " <symbol>" after a formatted amount
+inline std::to_chars_result append_symbol(std::to_chars_result r, char *last,
+                                          const char *symbol,
+                                          std::size_t length) {
+    if (r.ec != std::errc()) {
+        return r;
+    }
+    if (static_cast<std::size_t>(last - r.ptr) < length + 1) {
+        return {last, std::errc::value_too_large};
+    }
+    *r.ptr++ = ' ';
+    std::memcpy(r.ptr, symbol, length);
+    return {r.ptr + length, std::errc()};
+}
+
+} // namespace detail
+
+// Write "<amount> <symbol>" into [first, last). Any trailing arguments (a
+// std::chars_format and precision, or an integer base) are passed on to
+// std::to_chars for the amount. Like std::to_chars the output is not null
+// terminated, and std::errc::value_too_large is returned if it won't fit.
+template <typename rep, typename fraction, typename units_tag,
+          typename... format>
+std::to_chars_result to_chars(char *first, char *last,
+                              const units<rep, fraction, units_tag> &value,
+                              format... fmt) {
+    using symbol = units_symbol<units<rep, fraction, units_tag> >;
+    return detail::append_symbol(std::to_chars(first, last, value.amount(), fmt...),
+                                 last, symbol::value, symbol::length);
+}
+
+template <typename units1, typename units2, typename units_operator,
+          typename... format>
+std::to_chars_result to_chars(char *first, char *last,
+                              const units_pair<units1, units2, units_operator> &value,
+                              format... fmt) {
+    using symbol = units_symbol<units_pair<units1, units2, units_operator> >;
+    return detail::append_symbol(std::to_chars(first, last, value.amount(), fmt...),
+                                 last, symbol::value, symbol::length);
+}
+
+} // namespace units
+
+#if defined(__cpp_lib_format)
+
+namespace units {
+
+namespace detail {
+
+// Format the amount with the rep's own format spec, then the symbol
+template <typename unit>
+struct units_formatter : std::formatter<typename unit::rep, char> {
+    template <typename format_context>
+    auto format(const unit &value, format_context &ctx) const {
+        auto out = std::formatter<typename unit::rep, char>::format(
+            value.amount(), ctx);
+        *out++ = ' ';
+        return std::copy_n(units_symbol<unit>::value,
+                           units_symbol<unit>::length, out);
+    }
+};
+
+} // namespace detail
+
+} // namespace units
+
+template <typename rep, typename fraction, typename units_tag>
+struct std::formatter<units::units<rep, fraction, units_tag>, char>
+    : units::detail::units_formatter<units::units<rep, fraction, units_tag> > {};
+
+template <typename units1, typename units2, typename units_operator>
+struct std::formatter<units::units_pair<units1, units2, units_operator>, char>
+    : units::detail::units_formatter<
+          units::units_pair<units1, units2, units_operator> > {};
+
+#endif // __cpp_lib_format
+
+#endif//UNITS_FORMAT_H
@@ -0,0 +1,83 @@
+#ifndef UNITS_HASH_H
+#define UNITS_HASH_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+// Units
+#include "detail/units_cast_policy_impl.h"
+#include "units.h"
+
+namespace units {
+
+namespace detail {
+
+// Mix of a 64 bit value, so that nearby quantities spread over buckets
+inline std::size_t hash_mix(std::uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb93e85ebca53ull;
+    x ^= x >> 33;
+    return static_cast<std::size_t>(x);
+}
+
+template <typename unit,
+          bool floating = treat_as_floating_point<typename unit::rep>::value>
+struct units_hash;
+
+// Integral reps hash the exact amount in the base unit of their tag, as a
+// reduced fraction, so equal quantities in any unit hash equally
+template <typename unit>
+struct units_hash<unit, false> {
+    static std::size_t hash(const unit &u) noexcept {
+        using fraction = typename unit::fraction;
+        wide_int num = static_cast<wide_int>(u.amount()) * fraction::num;
+        wide_int den = fraction::den;
+        const wide_int g = wide_gcd(num < 0 ? -num : num, den);
+        if (g > 1) {
+            num /= g;
+            den /= g;
+        }
+        const std::uint64_t lo = static_cast<std::uint64_t>(num);
+        const std::uint64_t hi = static_cast<std::uint64_t>(num >> 32 >> 32);
+        return hash_mix(lo ^ hash_mix(hi ^ static_cast<std::uint64_t>(den)));
+    }
+};
+
+// Floating point reps hash the amount in the base unit, rounded once from
+// the exact product; zero of either sign hashes alike
+template <typename unit>
+struct units_hash<unit, true> {
+    static std::size_t hash(const unit &u) noexcept {
+        using fraction = typename unit::fraction;
+        using compute = typename compute_rep<typename unit::rep>::type;
+        const double base = static_cast<double>(
+            static_cast<long double>(static_cast<compute>(u.amount())) *
+            fraction::num / fraction::den) + 0.0;
+        std::uint64_t bits;
+        std::memcpy(&bits, &base, sizeof bits);
+        return hash_mix(bits);
+    }
+};
+
+} // namespace detail
+
+} // namespace units
+
+// Hash of a quantity rather than of its amount: 1 ft and 12 in hash
+// equally, consistent with the mixed unit ==. For floating point reps this
+// holds whenever the two amounts convert to the same base amount.
+template <typename rep, typename fraction, typename units_tag>
+struct std::hash<units::units<rep, fraction, units_tag> > {
+    std::size_t operator()(
+        const units::units<rep, fraction, units_tag> &u) const noexcept {
+        return units::detail::units_hash<
+            units::units<rep, fraction, units_tag> >::hash(u);
+    }
+};
+
+#endif//UNITS_HASH_H
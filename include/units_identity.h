@@ -0,0 +1,72 @@
+#ifndef UNITS_IDENTITY_H
+#define UNITS_IDENTITY_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+// Units
+#include "dimension.h"
+#include "units_fwd.h"
+
+namespace units {
+
+namespace detail {
+
+constexpr std::uint64_t identity_basis = 14695981039346656037ull;
+
+// 64 bit FNV-1a over the little endian bytes of v, so identities are the same
+// in every process and on every platform
+constexpr std::uint64_t identity_hash(std::uint64_t h, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        h = (h ^ ((v >> (8 * i)) & 0xff)) * 1099511628211ull;
+    }
+    return h;
+}
+
+constexpr std::uint64_t identity_hash(std::uint64_t h, const char *s) {
+    for (std::size_t i = 0; s[i] != '\0'; ++i) {
+        h = (h ^ static_cast<unsigned char>(s[i])) * 1099511628211ull;
+    }
+    return h;
+}
+
+template <typename...>
+using void_t = void;
+
+} // namespace detail
+
+// Identity of a units tag, stable across builds. Tags with a dimension are
+// identified by their exponent vector, so a base tag and the composite that
+// reduces to it are the same. Other tags specialize this next to their
+// aliases.
+template <typename units_tag, typename = void>
+struct units_tag_identity;
+
+template <typename units_tag>
+struct units_tag_identity<units_tag,
+    detail::void_t<typename dimension_of<units_tag>::type> > {
+    using dimension = typename dimension_of<units_tag>::type;
+    static constexpr std::uint64_t value = detail::identity_hash(
+        detail::identity_hash(
+            detail::identity_hash(detail::identity_basis,
+                                  static_cast<std::uint64_t>(dimension::distance)),
+            static_cast<std::uint64_t>(dimension::weight)),
+        static_cast<std::uint64_t>(dimension::time));
+};
+
+// Identity of a unit: its tag and fraction, but not its rep
+template <typename unit>
+struct units_identity;
+
+template <typename rep, typename fraction, typename units_tag>
+struct units_identity<units<rep, fraction, units_tag> > {
+    static constexpr std::uint64_t value = detail::identity_hash(
+        detail::identity_hash(units_tag_identity<units_tag>::value,
+                              static_cast<std::uint64_t>(fraction::num)),
+        static_cast<std::uint64_t>(fraction::den));
+};
+
+} // namespace units
+
+#endif//UNITS_IDENTITY_H
@@ -0,0 +1,177 @@
+#ifndef UNITS_INSTRUMENT_H
+#define UNITS_INSTRUMENT_H
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+// Units
+#include "detail/units_instrument_impl.h"
+
+#if UNITS_INSTRUMENT_CONVERSIONS && defined(__unix__)
+#include <dlfcn.h>
+#endif
+
+// Print the report to stderr when the program exits, if anything was counted
+#ifndef UNITS_CONVERSION_REPORT_AT_EXIT
+#define UNITS_CONVERSION_REPORT_AT_EXIT 1
+#endif
+
+namespace units {
+
+// Implicit conversions counted at one call site. The site is file:line for
+// conversions by construction, and object+offset of the return address,
+// for addr2line, for operators.
+struct conversion_count {
+    std::string from;
+    std::string to;
+    std::string site;
+    std::uint64_t count;
+};
+
+#if UNITS_INSTRUMENT_CONVERSIONS
+
+namespace detail {
+
+// The type name out of a conversion_type_signature
+inline std::string conversion_type_name(const char *signature) {
+    const char *first = std::strstr(signature, "T = ");
+    if (first == nullptr) {
+        return signature;
+    }
+    first += 4;
+    const char *last = first + std::strlen(first);
+    while (last != first && (last[-1] == ']' || last[-1] == ';')) {
+        --last;
+    }
+    return std::string(first, last);
+}
+
+inline std::string conversion_site_name(const conversion_site &site) {
+    char buf[32];
+    if (site.file != nullptr) {
+        std::snprintf(buf, sizeof buf, ":%u", site.line);
+        return site.file + std::string(buf);
+    }
+#if defined(__unix__)
+    // Offset into the loaded object, as addr2line -e takes it
+    Dl_info info;
+    if (dladdr(site.address, &info) != 0 && info.dli_fname != nullptr) {
+        const std::uintptr_t offset =
+            reinterpret_cast<std::uintptr_t>(site.address) -
+            reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+        std::snprintf(buf, sizeof buf, "+0x%llx",
+                      static_cast<unsigned long long>(offset));
+        return info.dli_fname + std::string(buf);
+    }
+#endif
+    std::snprintf(buf, sizeof buf, "%p", site.address);
+    return buf;
+}
+
+} // namespace detail
+
+// Counts of every thread, live and exited, merged by units and site and
+// sorted from most to least frequent
+inline std::vector<conversion_count> conversion_report() {
+    std::vector<detail::conversion_record> records;
+    {
+        detail::conversion_registry &r = detail::conversion_registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        records = r.retired;
+        for (const detail::conversion_table *t : r.live) {
+            t->collect(records);
+        }
+    }
+
+    std::vector<conversion_count> report;
+    for (const detail::conversion_record &rec : records) {
+        if (rec.count == 0) {
+            continue;
+        }
+        conversion_count c{detail::conversion_type_name(rec.kind->from()),
+                           detail::conversion_type_name(rec.kind->to()),
+                           detail::conversion_site_name(rec.site), rec.count};
+        auto same = std::find_if(report.begin(), report.end(),
+            [&c](const conversion_count &e) {
+                return e.from == c.from && e.to == c.to && e.site == c.site;
+            });
+        if (same != report.end()) {
+            same->count += c.count;
+        } else {
+            report.push_back(std::move(c));
+        }
+    }
+    std::sort(report.begin(), report.end(),
+              [](const conversion_count &a, const conversion_count &b) {
+                  return a.count != b.count ? a.count > b.count : a.site < b.site;
+              });
+    return report;
+}
+
+// Conversions that did not fit in a thread's table and were not counted
+inline std::uint64_t conversions_dropped() {
+    detail::conversion_registry &r = detail::conversion_registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::uint64_t dropped = r.retired_dropped;
+    for (const detail::conversion_table *t : r.live) {
+        dropped += t->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+// Zero every count. Conversions racing with the reset may be kept or lost.
+inline void reset_conversion_counts() {
+    detail::conversion_registry &r = detail::conversion_registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired.clear();
+    r.retired_dropped = 0;
+    for (detail::conversion_table *t : r.live) {
+        t->reset();
+    }
+}
+
+inline void print_conversion_report(std::FILE *out = stderr) {
+    const std::vector<conversion_count> report = conversion_report();
+    std::fprintf(out, "units: %zu implicit conversion sites\n", report.size());
+    for (const conversion_count &c : report) {
+        std::fprintf(out, "%12llu  %s\n              %s -> %s\n",
+                     static_cast<unsigned long long>(c.count), c.site.c_str(),
+                     c.from.c_str(), c.to.c_str());
+    }
+    const std::uint64_t dropped = conversions_dropped();
+    if (dropped != 0) {
+        std::fprintf(out, "%12llu  not counted: too many sites in one thread\n",
+                     static_cast<unsigned long long>(dropped));
+    }
+}
+
+namespace detail {
+
+inline void report_conversions_at_exit() {
+#if UNITS_CONVERSION_REPORT_AT_EXIT
+    if (!conversion_report().empty()) {
+        print_conversion_report(stderr);
+    }
+#endif
+}
+
+} // namespace detail
+
+#else
+
+// Instrumentation is compiled out: nothing is ever counted
+inline std::vector<conversion_count> conversion_report() { return {}; }
+inline std::uint64_t conversions_dropped() { return 0; }
+inline void reset_conversion_counts() {}
+inline void print_conversion_report(std::FILE* = stderr) {}
+
+#endif // UNITS_INSTRUMENT_CONVERSIONS
+
+} // namespace units
+
+#endif//UNITS_INSTRUMENT_H
@@ -0,0 +1,84 @@
+#ifndef UNITS_PACK_H
+#define UNITS_PACK_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+// Units
+#include "compact_rep.h"
+#include "detail/units_pack_impl.h"
+#include "quantity_array.h"
+
+namespace units {
+
+// pack_n: convert count floats at in into compact reps at out, with the SIMD
+// kernels the running CPU supports
+template <typename compact>
+typename std::enable_if<std::is_same<compact, float16>::value ||
+                        std::is_same<compact, bfloat16>::value>::type
+pack_n(const float *in, std::size_t count, compact *out) {
+    static const detail::pack_kernel<compact> kernel =
+        detail::select_pack_kernel<compact>();
+    kernel(in, count, out);
+}
+
+// unpack_n: convert count compact reps at in back into floats at out
+template <typename compact>
+typename std::enable_if<std::is_same<compact, float16>::value ||
+                        std::is_same<compact, bfloat16>::value>::type
+unpack_n(const compact *in, std::size_t count, float *out) {
+    static const detail::unpack_kernel<compact> kernel =
+        detail::select_unpack_kernel<compact>();
+    kernel(in, count, out);
+}
+
+// Fixed point packs from and unpacks to the floating point type it computes
+// in, rounding to nearest and saturating
+template <typename int_rep, typename scale>
+void pack_n(const typename fixed_point<int_rep, scale>::compute *in,
+            std::size_t count, fixed_point<int_rep, scale> *out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = fixed_point<int_rep, scale>(in[i]);
+    }
+}
+
+template <typename int_rep, typename scale>
+void unpack_n(const fixed_point<int_rep, scale> *in, std::size_t count,
+              typename fixed_point<int_rep, scale>::compute *out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = in[i];
+    }
+}
+
+// Pack or unpack units whose only difference is the rep. Converts as many
+// values as both spans hold, and returns that count.
+template <typename from_unit, typename to_unit>
+std::size_t pack_n(quantity_span<from_unit> in, quantity_span<to_unit> out) {
+    using from_type = typename quantity_span<from_unit>::value_type;
+    static_assert(std::is_same<typename from_type::fraction,
+                               typename to_unit::fraction>::value &&
+                  std::is_same<typename from_type::units_tag,
+                               typename to_unit::units_tag>::value,
+                  "pack_n changes the rep only; use units_cast_n first");
+    const std::size_t n = std::min(in.size(), out.size());
+    pack_n(in.raw_data(), n, out.raw_data());
+    return n;
+}
+
+template <typename from_unit, typename to_unit>
+std::size_t unpack_n(quantity_span<from_unit> in, quantity_span<to_unit> out) {
+    using from_type = typename quantity_span<from_unit>::value_type;
+    static_assert(std::is_same<typename from_type::fraction,
+                               typename to_unit::fraction>::value &&
+                  std::is_same<typename from_type::units_tag,
+                               typename to_unit::units_tag>::value,
+                  "unpack_n changes the rep only; use units_cast_n after");
+    const std::size_t n = std::min(in.size(), out.size());
+    unpack_n(in.raw_data(), n, out.raw_data());
+    return n;
+}
+
+} // namespace units
+
+#endif//UNITS_PACK_H
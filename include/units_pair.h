@@ -4,61 +4,136 @@
 #include <functional>
 #include <type_traits>
 
-#include "units_fwd.h"
+#include "dimension.h"
+#include "units.h"
 
 namespace units {
 
+namespace detail {
+
+// Composite unit named by a units_pair
+template <typename units1, typename units2, typename units_operator>
+struct units_pair_base;
+
+template <typename units1, typename units2, typename rep>
+struct units_pair_base<units1, units2, std::multiplies<rep> > {
+    using type = units_multiply<units1, units2>;
+};
+
+template <typename units1, typename units2, typename rep>
+struct units_pair_base<units1, units2, std::divides<rep> > {
+    using type = units_divide<units1, units2>;
+};
+
+// Composites a units_pair without an operator in its type exchanges amounts
+// with: the product and the quotient of its two units
+template <typename units1, typename units2, typename composite>
+struct is_pair_composite : std::integral_constant<bool,
+    std::is_same<composite, units_multiply<units1, units2> >::value ||
+    std::is_same<composite, units_divide<units1, units2> >::value> {};
+
+} // namespace detail
+
+// A units_pair names the composite unit formed from two units, and can be
+// built from one value of each. The operator combining them is part of the
+// type, so a units_pair carries nothing beyond its rep. Without one, see
+// units_pair<units1, units2, void> below.
+template <typename units1, typename units2, typename units_operator_ = void>
+struct units_pair
+    : public detail::units_pair_base<units1, units2, units_operator_>::type {
+
+    using base = typename detail::units_pair_base<
+        units1, units2, units_operator_>::type;
+    using rep = typename base::rep;
+    using units_operator = units_operator_;
+
+    constexpr units_pair() = default;
+    constexpr units_pair(const units_pair&) = default;
+    constexpr units_pair(units_pair&&) = default;
+    constexpr units_pair& operator=(const units_pair&) = default;
+    constexpr units_pair& operator=(units_pair&&) = default;
+    ~units_pair() noexcept = default;
+
+    constexpr units_pair(const rep &v,
+                         units_operator = units_operator()) noexcept
+        : base(v) {}
+
+    constexpr units_pair(const base &u) noexcept
+        : base(u) {}
+
+    constexpr units_pair(const units1 &u1, const units2 &u2) noexcept
+        : base(units_operator()(units_cast<units1>(u1).amount(),
+                                units_cast<units2>(u2).amount())) {}
+
+    static constexpr units_operator pair_operator() noexcept {
+        return units_operator();
+    }
+};
+
+// A units_pair without an operator in its type keeps the original form: an
+// amount held as units1, combined from one value of each unit by the
+// operator given on construction (std::multiplies unless another is), and
+// exchanged by amount with the product or quotient of the two units.
 template <typename units1, typename units2>
-struct units_pair : public units1 {
+struct units_pair<units1, units2, void> : public units1 {
 
+    using base = units1;
     using rep = typename units1::rep;
-    using units_operator = std::function<rep(const rep&, const rep&)>;
+    using units_operator = void;
 
     constexpr units_pair() = default;
-    units_pair(const units_pair&) = default;
-    units_pair(units_pair&&) = default;
-    units_pair& operator=(const units_pair&) = default;
-    units_pair& operator=(units_pair&&) = default;
+    constexpr units_pair(const units_pair&) = default;
+    constexpr units_pair(units_pair&&) = default;
+    constexpr units_pair& operator=(const units_pair&) = default;
+    constexpr units_pair& operator=(units_pair&&) = default;
     ~units_pair() noexcept = default;
 
-    constexpr units_pair(const rep &v, units_operator op = std::multiplies<rep>())
-        : units1(v), op_(op) {}
+    template <typename op = std::multiplies<rep> >
+    constexpr units_pair(const rep &v, op = op()) noexcept
+        : units1(v) {}
 
+    template <typename op = std::multiplies<rep> >
     constexpr units_pair(const units1 &u1, const units2 &u2,
-                         units_operator op = std::multiplies<rep>())
-        : units1(op(units_cast<units1>(u1).amount(),
-                    units_cast<units2>(u2).amount())),
-        op_(op) {}
+                         op combine = op()) noexcept
+        : units1(combine(units_cast<units1>(u1).amount(),
+                         units_cast<units2>(u2).amount())) {}
 
-    units_operator pair_operator() const { return op_; }
+    template <typename composite, typename = typename std::enable_if<
+                  detail::is_pair_composite<units1, units2, composite>::value>::type>
+    constexpr units_pair(const composite &u) noexcept
+        : units1(u.amount()) {}
 
-private:
-    units_operator op_;
-};
+    using units1::operator+=;
+    using units1::operator-=;
+
+    template <typename composite, typename = typename std::enable_if<
+                  detail::is_pair_composite<units1, units2, composite>::value>::type>
+    constexpr units_pair& operator+=(const composite &u) noexcept {
+        units1::operator+=(u.amount());
+        return *this;
+    }
+
+    template <typename composite, typename = typename std::enable_if<
+                  detail::is_pair_composite<units1, units2, composite>::value>::type>
+    constexpr units_pair& operator-=(const composite &u) noexcept {
+        units1::operator-=(u.amount());
+        return *this;
+    }
 
-template <typename rep,
-          typename fraction1, typename units_tag1,
-          typename fraction2, typename units_tag2>
-constexpr units_pair<units<rep, fraction1, units_tag1>,
-                     units<rep, fraction2, units_tag2> >
-operator*(const units<rep, fraction1, units_tag1> &u1,
-          const units<rep, fraction2, units_tag2> &u2) {
-    return units_pair<units<rep, fraction1, units_tag1>,
-                      units<rep, fraction2, units_tag2> >(
-        u1, u2, std::multiplies<rep>());
-}
-
-template <typename rep,
-          typename fraction1, typename units_tag1,
-          typename fraction2, typename units_tag2>
-constexpr units_pair<units<rep, fraction1, units_tag1>,
-                     units<rep, fraction2, units_tag2> >
-operator/(const units<rep, fraction1, units_tag1> &u1,
-          const units<rep, fraction2, units_tag2> &u2) {
-    return units_pair<units<rep, fraction1, units_tag1>,
-                      units<rep, fraction2, units_tag2> >(
-        u1, u2, std::divides<rep>());
-}
+    template <typename composite, typename = typename std::enable_if<
+                  detail::is_pair_composite<units1, units2, composite>::value>::type>
+    friend constexpr bool operator==(const units_pair &p,
+                                     const composite &u) noexcept {
+        return p.amount() == u.amount();
+    }
+
+    template <typename composite, typename = typename std::enable_if<
+                  detail::is_pair_composite<units1, units2, composite>::value>::type>
+    friend constexpr bool operator!=(const units_pair &p,
+                                     const composite &u) noexcept {
+        return !(p == u);
+    }
+};
 
 } // namespace units
 
@@ -0,0 +1,248 @@
+#ifndef UNITS_PARSE_H
+#define UNITS_PARSE_H
+
+// STL
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+// Units
+#include "detail/units_cast_policy_impl.h"
+#include "quantity_array.h"
+#include "units.h"
+#include "units_symbol.h"
+
+namespace units {
+
+namespace detail {
+
+constexpr bool is_symbol_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        static_cast<unsigned char>(c) >= 0x80;
+}
+
+// Blanks around values, unless the blank is the delimiter
+constexpr bool is_blank(char c, char delimiter = '\0') {
+    return c != delimiter && (c == ' ' || c == '\t' || c == '\r');
+}
+
+constexpr const char* skip_blanks(const char *first, const char *last,
+                                  char delimiter = '\0') {
+    while (first != last && is_blank(*first, delimiter)) {
+        ++first;
+    }
+    return first;
+}
+
+// Scale from every symbol of a dimension into the fraction of unit
+template <typename unit,
+          bool floating = std::is_floating_point<typename unit::rep>::value>
+struct symbol_scale;
+
+// Floating point: one factor per symbol, folded at compile time
+template <typename unit>
+struct symbol_scale<unit, true> {
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using symbols = units_symbols<typename unit::units_tag>;
+    static constexpr std::size_t size = std::size(symbols::table);
+
+    static constexpr std::array<rep, size> make_factors() {
+        std::array<rep, size> factors{};
+        for (std::size_t i = 0; i < size; ++i) {
+            factors[i] = static_cast<rep>(
+                static_cast<long double>(symbols::table[i].num) /
+                static_cast<long double>(symbols::table[i].den) *
+                static_cast<long double>(fraction::den) /
+                static_cast<long double>(fraction::num));
+        }
+        return factors;
+    }
+
+    static constexpr std::array<rep, size> factors = make_factors();
+
+    static std::from_chars_result parse(const char *first, const char *last,
+                                        rep &v) {
+        return std::from_chars(first, last, v);
+    }
+
+    static bool scale(rep v, int symbol, rep &out) {
+        out = v * factors[symbol];
+        return true;
+    }
+};
+
+// Integers: an exact reduced ratio per symbol, rounded to nearest
+template <typename unit>
+struct symbol_scale<unit, false> {
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using symbols = units_symbols<typename unit::units_tag>;
+    static constexpr std::size_t size = std::size(symbols::table);
+
+    struct ratio {
+        wide_int num;
+        wide_int den;
+    };
+
+    static constexpr std::array<ratio, size> make_ratios() {
+        std::array<ratio, size> ratios{};
+        for (std::size_t i = 0; i < size; ++i) {
+            const wide_int num = wide_int(symbols::table[i].num) * fraction::den;
+            const wide_int den = wide_int(symbols::table[i].den) * fraction::num;
+            const wide_int g = wide_gcd(num, den);
+            ratios[i] = ratio{num / g, den / g};
+        }
+        return ratios;
+    }
+
+    static constexpr std::array<ratio, size> ratios = make_ratios();
+
+    static std::from_chars_result parse(const char *first, const char *last,
+                                        std::intmax_t &v) {
+        return std::from_chars(first, last, v);
+    }
+
+    static bool scale(std::intmax_t v, int symbol, rep &out) {
+        const ratio r = ratios[symbol];
+        if (v > wide_int_max / r.num || v < -(wide_int_max / r.num)) {
+            return false;
+        }
+        const wide_int w = rounded_divide(wide_int(v) * r.num, r.den,
+                                          rounding::nearest());
+        if (w < wide_int((std::numeric_limits<rep>::lowest)()) ||
+            w > wide_int((std::numeric_limits<rep>::max)())) {
+            return false;
+        }
+        out = static_cast<rep>(w);
+        return true;
+    }
+};
+
+} // namespace detail
+
+// Parse "<number> <symbol>" from [first, last) into value, converting from
+// the unit named by the symbol. The symbol must belong to the dimension of
+// value. Like std::from_chars: no leading whitespace, value is only written
+// on success, and on failure ptr points at the offending character.
+// Integral reps accept integral numbers only, rounding to the nearest value.
+template <typename rep, typename fraction, typename units_tag>
+std::from_chars_result from_chars(const char *first, const char *last,
+                                  units<rep, fraction, units_tag> &value) {
+    using scale = detail::symbol_scale<units<rep, fraction, units_tag> >;
+    using index = detail::symbol_index<units_tag>;
+
+    typename std::conditional<std::is_floating_point<rep>::value,
+                              rep, std::intmax_t>::type amount{};
+    const std::from_chars_result number = scale::parse(first, last, amount);
+    if (number.ec != std::errc()) {
+        return number;
+    }
+
+    const char *symbol = detail::skip_blanks(number.ptr, last);
+    const char *symbol_end = symbol;
+    while (symbol_end != last && detail::is_symbol_char(*symbol_end)) {
+        ++symbol_end;
+    }
+    const int i = index::find(symbol,
+                              static_cast<std::size_t>(symbol_end - symbol));
+    if (i < 0) {
+        return {symbol, std::errc::invalid_argument};
+    }
+
+    rep v;
+    if (!scale::scale(amount, i, v)) {
+        return {first, std::errc::result_out_of_range};
+    }
+    value = units<rep, fraction, units_tag>(v);
+    return {symbol_end, std::errc()};
+}
+
+// Result of parsing, offset is where parsing stopped or failed
+template <typename unit>
+struct parse_result {
+    unit value;
+    std::errc ec;
+    std::size_t offset;
+};
+
+// Parse a single quantity, surrounding blanks allowed
+template <typename unit>
+parse_result<unit> parse(std::string_view text) {
+    const char *first = text.data();
+    const char *last = first + text.size();
+    parse_result<unit> result{unit(), std::errc(), 0};
+
+    const char *p = detail::skip_blanks(first, last);
+    std::from_chars_result r = from_chars(p, last, result.value);
+    if (r.ec == std::errc()) {
+        r.ptr = detail::skip_blanks(r.ptr, last);
+        if (r.ptr != last) {
+            r.ec = std::errc::invalid_argument;
+        }
+    }
+    result.ec = r.ec;
+    result.offset = static_cast<std::size_t>(r.ptr - first);
+    return result;
+}
+
+// Result of parsing a batch: count values were written, and on failure
+// offset is where the error was found
+struct parse_n_result {
+    std::size_t count;
+    std::errc ec;
+    std::size_t offset;
+};
+
+// Parse delimited quantities into out, stopping at the first error or when
+// out is full (std::errc::value_too_large). Blanks around values and a
+// trailing delimiter are allowed.
+template <typename unit>
+parse_n_result parse_n(std::string_view text, char delimiter,
+                       quantity_span<unit> out) {
+    const char *first = text.data();
+    const char *last = first + text.size();
+    parse_n_result result{0, std::errc(), 0};
+
+    const char *p = first;
+    while (true) {
+        p = detail::skip_blanks(p, last, delimiter);
+        if (p == last) {
+            break;
+        }
+        result.offset = static_cast<std::size_t>(p - first);
+        if (result.count == out.size()) {
+            result.ec = std::errc::value_too_large;
+            return result;
+        }
+
+        std::from_chars_result r = from_chars(p, last, out[result.count]);
+        if (r.ec != std::errc()) {
+            result.ec = r.ec;
+            result.offset = static_cast<std::size_t>(r.ptr - first);
+            return result;
+        }
+        p = detail::skip_blanks(r.ptr, last, delimiter);
+        if (p != last && *p != delimiter) {
+            result.ec = std::errc::invalid_argument;
+            result.offset = static_cast<std::size_t>(p - first);
+            return result;
+        }
+        ++result.count;
+        if (p == last) {
+            break;
+        }
+        ++p;
+    }
+    result.offset = static_cast<std::size_t>(p - first);
+    return result;
+}
+
+} // namespace units
+
+#endif//UNITS_PARSE_H
@@ -0,0 +1,181 @@
+#ifndef UNITS_POINT_H
+#define UNITS_POINT_H
+
+// STL
+#include <cstddef>
+#include <ratio>
+#include <type_traits>
+// Units
+#include "detail/units_point_impl.h"
+#include "units.h"
+
+namespace units {
+
+// A units_point is an absolute position on an affine scale, such as a
+// temperature or an elevation above a datum, as std::chrono::time_point is
+// to duration. It is stored as the unit elapsed since its origin, and the
+// origin is a compile time ratio in the base unit of the tag.
+//
+// Points and differences do not mix freely: point - point is a unit,
+// point +/- unit is a point, and points cannot be added.
+template <typename unit_, typename origin_ = std::ratio<0> >
+struct units_point {
+    static_assert(is_unit<unit_>::value, "units_point must be over a unit");
+
+    using unit = unit_;
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using units_tag = typename unit::units_tag;
+    using origin = origin_;
+
+    constexpr units_point() = default;
+
+    constexpr explicit units_point(const unit &since_origin) noexcept
+        : since_origin_(since_origin) {}
+
+    template <typename rep2,
+              typename = typename std::enable_if<
+                  std::is_constructible<unit, const rep2&>::value>::type>
+    constexpr explicit units_point(const rep2 &v) noexcept
+        : since_origin_(v) {}
+
+    constexpr unit since_origin() const noexcept { return since_origin_; }
+    constexpr rep amount() const noexcept { return since_origin_.amount(); }
+
+    // Moving a point by a difference results in the same point
+    template <typename rep2, typename frac2>
+    constexpr units_point& operator+=(
+        const units<rep2, frac2, units_tag> &u) noexcept {
+        since_origin_ += u;
+        return *this;
+    }
+
+    template <typename rep2, typename frac2>
+    constexpr units_point& operator-=(
+        const units<rep2, frac2, units_tag> &u) noexcept {
+        since_origin_ -= u;
+        return *this;
+    }
+
+private:
+    unit since_origin_;
+};
+
+// Check if something is a units_point type
+template <typename T>
+struct is_units_point : std::false_type {};
+
+template <typename unit, typename origin>
+struct is_units_point<units_point<unit, origin> > : std::true_type {};
+
+// units_point_cast: one multiply-add, with the scale and offset folded from
+// both fractions and origins at compile time. Integral reps truncate.
+template <typename to_point, typename unit, typename origin>
+constexpr typename std::enable_if<is_units_point<to_point>::value, to_point>::type
+units_point_cast(const units_point<unit, origin> &p) noexcept {
+    using from_point = units_point<unit, origin>;
+    static_assert(is_unit_convertible<typename to_point::unit, unit>::value,
+                  "units must be convertible in order to cast");
+    using transform = detail::affine_transform<from_point, to_point>;
+    using common_rep = detail::common_rep<typename to_point::rep,
+                                          typename unit::rep>;
+    using uc = detail::units_point_cast_impl<to_point, transform, common_rep>;
+    return to_point(uc::cast(p.amount()));
+}
+
+// units_point_cast_n: convert count raw reps of from_point at in into
+// to_point reps at out. in and out may be the same buffer.
+template <typename to_point, typename from_point>
+typename std::enable_if<is_units_point<to_point>::value &&
+                        is_units_point<from_point>::value>::type
+units_point_cast_n(const typename from_point::rep *in, std::size_t count,
+                   typename to_point::rep *out) {
+    static_assert(is_unit_convertible<typename to_point::unit,
+                                      typename from_point::unit>::value,
+                  "units must be convertible in order to cast");
+    using to_rep = typename to_point::rep;
+    using from_rep = typename from_point::rep;
+    using uc = detail::units_point_cast_n_impl<to_point, from_point,
+        std::is_same<to_rep, from_rep>::value &&
+        std::is_floating_point<to_rep>::value>;
+
+    uc::cast(in, count, out);
+}
+
+// Comparison of points on the same scale
+template <typename unit1, typename unit2, typename origin>
+constexpr bool operator==(const units_point<unit1, origin> &p1,
+                const units_point<unit2, origin> &p2) noexcept {
+    return p1.since_origin() == p2.since_origin();
+}
+
+template <typename unit1, typename unit2, typename origin>
+constexpr bool operator!=(const units_point<unit1, origin> &p1,
+                const units_point<unit2, origin> &p2) noexcept {
+    return !(p1 == p2);
+}
+
+template <typename unit1, typename unit2, typename origin>
+constexpr bool operator<(const units_point<unit1, origin> &p1,
+               const units_point<unit2, origin> &p2) noexcept {
+    return p1.since_origin() < p2.since_origin();
+}
+
+template <typename unit1, typename unit2, typename origin>
+constexpr bool operator>(const units_point<unit1, origin> &p1,
+               const units_point<unit2, origin> &p2) noexcept {
+    return p2 < p1;
+}
+
+template <typename unit1, typename unit2, typename origin>
+constexpr bool operator<=(const units_point<unit1, origin> &p1,
+                const units_point<unit2, origin> &p2) noexcept {
+    return !(p2 < p1);
+}
+
+template <typename unit1, typename unit2, typename origin>
+constexpr bool operator>=(const units_point<unit1, origin> &p1,
+                const units_point<unit2, origin> &p2) noexcept {
+    return !(p1 < p2);
+}
+
+// A point moved by a difference is a point in their common unit
+template <typename unit, typename origin, typename rep2, typename frac2>
+constexpr units_point<typename std::common_type<
+    unit, units<rep2, frac2, typename unit::units_tag> >::type, origin>
+operator+(const units_point<unit, origin> &p,
+          const units<rep2, frac2, typename unit::units_tag> &u) noexcept {
+    using result = units_point<typename std::common_type<
+        unit, units<rep2, frac2, typename unit::units_tag> >::type, origin>;
+    return result(p.since_origin() + u);
+}
+
+template <typename unit, typename origin, typename rep2, typename frac2>
+constexpr units_point<typename std::common_type<
+    unit, units<rep2, frac2, typename unit::units_tag> >::type, origin>
+operator+(const units<rep2, frac2, typename unit::units_tag> &u,
+          const units_point<unit, origin> &p) noexcept {
+    return p + u;
+}
+
+template <typename unit, typename origin, typename rep2, typename frac2>
+constexpr units_point<typename std::common_type<
+    unit, units<rep2, frac2, typename unit::units_tag> >::type, origin>
+operator-(const units_point<unit, origin> &p,
+          const units<rep2, frac2, typename unit::units_tag> &u) noexcept {
+    using result = units_point<typename std::common_type<
+        unit, units<rep2, frac2, typename unit::units_tag> >::type, origin>;
+    return result(p.since_origin() - u);
+}
+
+// The difference of two points on the same scale is a unit
+template <typename unit1, typename unit2, typename origin>
+constexpr typename std::common_type<unit1, unit2>::type
+operator-(const units_point<unit1, origin> &p1,
+          const units_point<unit2, origin> &p2) noexcept {
+    return p1.since_origin() - p2.since_origin();
+}
+
+} // namespace units
+
+#endif//UNITS_POINT_H
@@ -0,0 +1,230 @@
+#ifndef UNITS_REDUCE_H
+#define UNITS_REDUCE_H
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <future>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+// Units
+#include "dimension.h"
+#include "quantity_array.h"
+#include "units.h"
+#include "units_cast.h"
+
+namespace units {
+
+// Ranges at least this long per thread are reduced across threads
+constexpr std::size_t parallel_reduce_grain = std::size_t(1) << 18;
+
+namespace detail {
+
+// Floating point reduces in at least double, integers in their own rep
+template <typename rep>
+using reduce_accumulator = typename std::conditional<
+    treat_as_floating_point<rep>::value, common_rep<rep, double>, rep>::type;
+
+// Independent lanes let the compiler vectorize each block
+constexpr std::size_t reduce_lanes = 8;
+constexpr std::size_t reduce_block = 256;
+
+// Pairwise summation of f(i) over [0, n): error grows with log n rather than n
+template <typename acc, typename term>
+acc pairwise_sum(std::size_t first, std::size_t n, const term &f) {
+    if (n <= reduce_block) {
+        acc lanes[reduce_lanes] = {};
+        std::size_t i = 0;
+        for (; i + reduce_lanes <= n; i += reduce_lanes) {
+            for (std::size_t j = 0; j < reduce_lanes; ++j) {
+                lanes[j] += f(first + i + j);
+            }
+        }
+        for (; i < n; ++i) {
+            lanes[0] += f(first + i);
+        }
+        for (std::size_t w = reduce_lanes / 2; w > 0; w /= 2) {
+            for (std::size_t j = 0; j < w; ++j) {
+                lanes[j] += lanes[j + w];
+            }
+        }
+        return lanes[0];
+    }
+    const std::size_t half = n / 2 / reduce_lanes * reduce_lanes;
+    return pairwise_sum<acc>(first, half, f) +
+        pairwise_sum<acc>(first + half, n - half, f);
+}
+
+// Sum of partial results, compensated (Kahan-Babuska) for floating point
+template <typename acc>
+acc compensated_sum(const std::vector<acc> &partials, std::true_type) {
+    acc s = 0, c = 0;
+    for (acc x : partials) {
+        const acc t = s + x;
+        c += std::abs(s) >= std::abs(x) ? (s - t) + x : (x - t) + s;
+        s = t;
+    }
+    return s + c;
+}
+
+template <typename acc>
+acc compensated_sum(const std::vector<acc> &partials, std::false_type) {
+    acc s = 0;
+    for (acc x : partials) {
+        s += x;
+    }
+    return s;
+}
+
+// Split [0, n) into one chunk per thread when it is large enough, reduce
+// each with chunk(first, count) and return the partial results
+template <typename result, typename reducer>
+std::vector<result> parallel_chunks(std::size_t n, const reducer &chunk) {
+    const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t threads = std::max<std::size_t>(
+        1, std::min(hw, n / parallel_reduce_grain));
+    std::vector<result> partials(threads);
+    if (threads == 1) {
+        partials[0] = chunk(0, n);
+        return partials;
+    }
+
+    const std::size_t per_thread = (n + threads - 1) / threads;
+    std::vector<std::future<result> > futures;
+    for (std::size_t t = 1; t < threads; ++t) {
+        const std::size_t first = std::min(n, t * per_thread);
+        const std::size_t count = std::min(n - first, per_thread);
+        futures.push_back(std::async(std::launch::async, [&chunk, first, count] {
+            return chunk(first, count);
+        }));
+    }
+    partials[0] = chunk(0, std::min(n, per_thread));
+    for (std::size_t t = 1; t < threads; ++t) {
+        partials[t] = futures[t - 1].get();
+    }
+    return partials;
+}
+
+// Sum of f(i) over [0, n)
+template <typename acc, typename term>
+acc reduce_sum(std::size_t n, const term &f) {
+    auto partials = parallel_chunks<acc>(n, [&f](std::size_t first,
+                                                 std::size_t count) {
+        return pairwise_sum<acc>(first, count, f);
+    });
+    return compensated_sum(partials, std::is_floating_point<acc>());
+}
+
+// Smallest (or largest with greater) amount over a range
+template <typename rep, typename compare>
+rep reduce_extreme(const rep *x, std::size_t n, rep identity,
+                   const compare &better) {
+    auto partials = parallel_chunks<rep>(n, [&](std::size_t first,
+                                                std::size_t count) {
+        rep lanes[reduce_lanes];
+        std::fill(lanes, lanes + reduce_lanes, identity);
+        std::size_t i = 0;
+        for (; i + reduce_lanes <= count; i += reduce_lanes) {
+            for (std::size_t j = 0; j < reduce_lanes; ++j) {
+                const rep v = x[first + i + j];
+                lanes[j] = better(v, lanes[j]) ? v : lanes[j];
+            }
+        }
+        for (; i < count; ++i) {
+            const rep v = x[first + i];
+            lanes[0] = better(v, lanes[0]) ? v : lanes[0];
+        }
+        return *std::min_element(lanes, lanes + reduce_lanes, better);
+    });
+    return *std::min_element(partials.begin(), partials.end(), better);
+}
+
+// Result unit of a reduction: the unit reduced unless one was asked for
+template <typename to_unit, typename unit>
+using reduce_result = typename std::conditional<
+    std::is_void<to_unit>::value, unit, to_unit>::type;
+
+} // namespace detail
+
+// Sum of a range of units, in a wider accumulator for floating point
+// and pairwise within each thread. Summing into another unit scales the
+// total once rather than every value.
+template <typename to_unit = void, typename unit>
+detail::reduce_result<to_unit, typename quantity_span<unit>::value_type>
+sum(quantity_span<unit> values) {
+    using value_type = typename quantity_span<unit>::value_type;
+    using rep = typename value_type::rep;
+    using acc = detail::reduce_accumulator<rep>;
+    const rep *x = values.raw_data();
+    const acc total = detail::reduce_sum<acc>(values.size(), [x](std::size_t i) {
+        return static_cast<acc>(x[i]);
+    });
+    using result = detail::reduce_result<to_unit, value_type>;
+    return units_cast<result>(
+        units<acc, typename value_type::fraction,
+              typename value_type::units_tag>(total));
+}
+
+// Arithmetic mean of a range of units, zero for an empty range
+template <typename to_unit = void, typename unit>
+detail::reduce_result<to_unit, typename quantity_span<unit>::value_type>
+mean(quantity_span<unit> values) {
+    using value_type = typename quantity_span<unit>::value_type;
+    using acc = detail::reduce_accumulator<typename value_type::rep>;
+    using result = detail::reduce_result<to_unit, value_type>;
+    if (values.empty()) {
+        return result(0);
+    }
+    const auto total = sum<units<acc, typename value_type::fraction,
+                                 typename value_type::units_tag> >(values);
+    return units_cast<result>(total / static_cast<acc>(values.size()));
+}
+
+// Smallest and largest of a range of units. An empty range gives the
+// largest and smallest representable amounts respectively.
+template <typename unit>
+typename quantity_span<unit>::value_type minimum(quantity_span<unit> values) {
+    using value_type = typename quantity_span<unit>::value_type;
+    using rep = typename value_type::rep;
+    return value_type(detail::reduce_extreme(
+        values.raw_data(), values.size(), (std::numeric_limits<rep>::max)(),
+        [](rep a, rep b) { return a < b; }));
+}
+
+template <typename unit>
+typename quantity_span<unit>::value_type maximum(quantity_span<unit> values) {
+    using value_type = typename quantity_span<unit>::value_type;
+    using rep = typename value_type::rep;
+    return value_type(detail::reduce_extreme(
+        values.raw_data(), values.size(), std::numeric_limits<rep>::lowest(),
+        [](rep a, rep b) { return a > b; }));
+}
+
+// Dot product of two ranges of units, in the composite unit of their
+// product unless another unit is asked for. Only the common length of the
+// two ranges is used.
+template <typename to_unit = void, typename unit1, typename unit2>
+detail::reduce_result<to_unit, units_multiply<
+    typename quantity_span<unit1>::value_type,
+    typename quantity_span<unit2>::value_type> >
+dot(quantity_span<unit1> a, quantity_span<unit2> b) {
+    using product = units_multiply<typename quantity_span<unit1>::value_type,
+                                   typename quantity_span<unit2>::value_type>;
+    using acc = detail::reduce_accumulator<typename product::rep>;
+    const auto *x = a.raw_data();
+    const auto *y = b.raw_data();
+    const acc total = detail::reduce_sum<acc>(
+        std::min(a.size(), b.size()), [x, y](std::size_t i) {
+            return static_cast<acc>(x[i]) * static_cast<acc>(y[i]);
+        });
+    return units_cast<detail::reduce_result<to_unit, product> >(
+        units<acc, typename product::fraction,
+              typename product::units_tag>(total));
+}
+
+} // namespace units
+
+#endif//UNITS_REDUCE_H
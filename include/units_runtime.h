@@ -0,0 +1,238 @@
+#ifndef UNITS_RUNTIME_H
+#define UNITS_RUNTIME_H
+
+// STL
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+// Units
+#include "detail/units_cast_n_impl.h"
+#include "detail/units_cast_policy_impl.h"
+#include "units_symbol.h"
+
+namespace units {
+
+// Runtime id of a unit within a dimension, for data whose unit is only known
+// at runtime. Ids number the distinct fractions of units_symbols<units_tag>
+// in table order; a default constructed id is invalid.
+template <typename units_tag>
+struct unit_id {
+    int index = -1;
+
+    constexpr explicit operator bool() const noexcept { return index >= 0; }
+};
+
+template <typename units_tag>
+constexpr bool operator==(unit_id<units_tag> id1, unit_id<units_tag> id2) noexcept {
+    return id1.index == id2.index;
+}
+
+template <typename units_tag>
+constexpr bool operator!=(unit_id<units_tag> id1, unit_id<units_tag> id2) noexcept {
+    return !(id1 == id2);
+}
+
+namespace detail {
+
+// Distinct fractions of a symbol table, and the id of each symbol
+template <typename units_tag>
+struct unit_id_table {
+    using symbols = units_symbols<units_tag>;
+    static constexpr std::size_t symbol_count = std::size(symbols::table);
+
+    static constexpr int first_symbol(std::size_t i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            if (symbols::table[j].num == symbols::table[i].num &&
+                symbols::table[j].den == symbols::table[i].den) {
+                return static_cast<int>(j);
+            }
+        }
+        return static_cast<int>(i);
+    }
+
+    static constexpr std::size_t count_ids() {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < symbol_count; ++i) {
+            n += first_symbol(i) == static_cast<int>(i) ? 1 : 0;
+        }
+        return n;
+    }
+
+    static constexpr std::size_t size = count_ids();
+
+    using id_array = std::array<int, symbol_count>;
+    using symbol_array = std::array<int, size>;
+
+    static constexpr id_array make_ids() {
+        id_array ids{};
+        int next = 0;
+        for (std::size_t i = 0; i < symbol_count; ++i) {
+            const int first = first_symbol(i);
+            ids[i] = first == static_cast<int>(i) ? next++ : ids[first];
+        }
+        return ids;
+    }
+
+    static constexpr symbol_array make_canonical() {
+        symbol_array canonical{};
+        for (std::size_t i = 0, id = 0; i < symbol_count; ++i) {
+            if (first_symbol(i) == static_cast<int>(i)) {
+                canonical[id++] = static_cast<int>(i);
+            }
+        }
+        return canonical;
+    }
+
+    // Id of every symbol, and the canonical symbol of every id
+    static constexpr id_array ids = make_ids();
+    static constexpr symbol_array canonical = make_canonical();
+
+    static constexpr int find(std::intmax_t num, std::intmax_t den) {
+        for (std::size_t i = 0; i < symbol_count; ++i) {
+            if (symbols::table[i].num == num && symbols::table[i].den == den) {
+                return ids[i];
+            }
+        }
+        return -1;
+    }
+
+    static constexpr const symbol_entry& entry(std::size_t id) {
+        return symbols::table[canonical[id]];
+    }
+};
+
+// Reduced fraction from one unit to another, for integral reps
+struct runtime_fraction {
+    wide_int num;
+    wide_int den;
+};
+
+// Scale n values by a factor of the matrix. Floating point reps can't
+// fail; integral reps fail as rescale_n does, or if the factor doesn't
+// pass rescale_fits, in which case out is left as it was.
+template <typename rep>
+inline std::errc checked_scale_n(const rep *in, std::size_t n, rep *out,
+                                 rep factor) {
+    scale_n(in, n, out, factor);
+    return std::errc();
+}
+
+template <typename rep>
+inline std::errc checked_scale_n(const rep *in, std::size_t n, rep *out,
+                                 const runtime_fraction &factor) {
+    if (!rescale_fits<rep>(factor.num, std::false_type())) {
+        return std::errc::invalid_argument;
+    }
+    return rescale_n(in, n, out, factor.num, factor.den, std::false_type()) ?
+        std::errc() : std::errc::result_out_of_range;
+}
+
+// Conversion factors between every pair of ids of a dimension
+template <typename units_tag, typename rep,
+          bool floating = std::is_floating_point<rep>::value>
+struct unit_factor_matrix {
+    using table = unit_id_table<units_tag>;
+    static constexpr std::size_t size = table::size;
+    using matrix_type = std::array<std::array<rep, size>, size>;
+
+    static constexpr matrix_type make_matrix() {
+        matrix_type m{};
+        for (std::size_t f = 0; f < size; ++f) {
+            for (std::size_t t = 0; t < size; ++t) {
+                m[f][t] = static_cast<rep>(
+                    static_cast<long double>(table::entry(f).num) *
+                    static_cast<long double>(table::entry(t).den) /
+                    (static_cast<long double>(table::entry(f).den) *
+                     static_cast<long double>(table::entry(t).num)));
+            }
+        }
+        return m;
+    }
+
+    static constexpr matrix_type matrix = make_matrix();
+};
+
+template <typename units_tag, typename rep>
+struct unit_factor_matrix<units_tag, rep, false> {
+    using table = unit_id_table<units_tag>;
+    static constexpr std::size_t size = table::size;
+    using matrix_type = std::array<std::array<runtime_fraction, size>, size>;
+
+    static constexpr matrix_type make_matrix() {
+        matrix_type m{};
+        for (std::size_t f = 0; f < size; ++f) {
+            for (std::size_t t = 0; t < size; ++t) {
+                const wide_int num = wide_int(table::entry(f).num) * table::entry(t).den;
+                const wide_int den = wide_int(table::entry(f).den) * table::entry(t).num;
+                const wide_int g = wide_gcd(num, den);
+                m[f][t] = runtime_fraction{num / g, den / g};
+            }
+        }
+        return m;
+    }
+
+    static constexpr matrix_type matrix = make_matrix();
+};
+
+} // namespace detail
+
+// Number of runtime ids of a dimension
+template <typename units_tag>
+constexpr std::size_t unit_id_count() noexcept {
+    return detail::unit_id_table<units_tag>::size;
+}
+
+// Id of a unit symbol, invalid if the dimension has no such symbol
+template <typename units_tag>
+constexpr unit_id<units_tag> find_unit_id(std::string_view symbol) noexcept {
+    const int i = detail::symbol_index<units_tag>::find(symbol.data(),
+                                                         symbol.size());
+    return unit_id<units_tag>{
+        i < 0 ? -1 : detail::unit_id_table<units_tag>::ids[i]};
+}
+
+// Id of a unit type, known at compile time
+template <typename unit>
+constexpr unit_id<typename unit::units_tag> unit_id_of() noexcept {
+    using table = detail::unit_id_table<typename unit::units_tag>;
+    constexpr int id = table::find(unit::fraction::num, unit::fraction::den);
+    static_assert(id >= 0, "unit has no symbol and therefore no runtime id");
+    return unit_id<typename unit::units_tag>{id};
+}
+
+// Canonical symbol of a valid id
+template <typename units_tag>
+constexpr const char* unit_id_symbol(unit_id<units_tag> id) noexcept {
+    return detail::unit_id_table<units_tag>::entry(id.index).symbol;
+}
+
+// Factor from one valid id to another, precomputed for every pair
+template <typename rep, typename units_tag>
+constexpr rep unit_id_factor(unit_id<units_tag> from, unit_id<units_tag> to) noexcept {
+    static_assert(std::is_floating_point<rep>::value,
+                  "unit_id_factor is only defined for floating point reps");
+    return detail::unit_factor_matrix<units_tag, rep>::matrix[from.index][to.index];
+}
+
+// units_cast_n between units known at runtime: one lookup in the factor
+// matrix, then the same kernels as the compile time conversion. Both ids
+// must be valid; in and out may be the same buffer. Integral values that
+// don't fit the rep saturate, and std::errc::result_out_of_range is
+// returned if any did. std::errc::invalid_argument is returned, and
+// nothing converted, if the factor is too large to scale every value of
+// an integral rep exactly.
+template <typename units_tag, typename rep>
+std::errc units_cast_n(unit_id<units_tag> from, unit_id<units_tag> to,
+                       const rep *in, std::size_t count, rep *out) {
+    using matrix = detail::unit_factor_matrix<units_tag, rep>;
+    return detail::checked_scale_n(in, count, out,
+                                   matrix::matrix[from.index][to.index]);
+}
+
+} // namespace units
+
+#endif//UNITS_RUNTIME_H
@@ -0,0 +1,232 @@
+#ifndef UNITS_SERIALIZE_H
+#define UNITS_SERIALIZE_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+// Units
+#include "detail/units_cast_n_impl.h"
+#include "detail/units_cast_policy_impl.h"
+#include "quantity_array.h"
+#include "units.h"
+#include "units_identity.h"
+
+namespace units {
+
+// Serialized units start with a units_header, padded to units_header_size,
+// followed by count reps in native byte order. A buffer aligned to
+// quantity_alignment, such as an mmap or a quantity_array, therefore has an
+// aligned payload that can be viewed in place.
+struct units_header {
+    char magic[4];
+    std::uint16_t version;
+    std::uint8_t rep_code;
+    std::uint8_t byte_order;
+    std::uint64_t unit_identity;
+    std::uint64_t tag_identity;
+    std::int64_t num;
+    std::int64_t den;
+    std::uint64_t count;
+};
+
+constexpr std::size_t units_header_size = quantity_alignment;
+
+static_assert(sizeof(units_header) <= units_header_size,
+              "units_header must fit in its padding");
+
+namespace detail {
+
+constexpr char header_magic[4] = {'U', 'N', 'I', 'T'};
+constexpr std::uint16_t header_version = 1;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr std::uint8_t native_byte_order = 2;
+#else
+constexpr std::uint8_t native_byte_order = 1;
+#endif
+
+// Rep type code: signed, unsigned or floating point in the high nibble, size
+// in bytes in the low nibble
+template <typename rep>
+struct rep_code {
+    static_assert(std::is_arithmetic<rep>::value &&
+                  !std::is_same<rep, bool>::value && sizeof(rep) <= 8,
+                  "rep cannot be serialized");
+    static constexpr std::uint8_t value = static_cast<std::uint8_t>(
+        (std::is_floating_point<rep>::value ? 0x30 :
+         std::is_signed<rep>::value ? 0x10 : 0x20) | sizeof(rep));
+};
+
+template <typename unit>
+units_header make_header(std::size_t count) noexcept {
+    using fraction = typename unit::fraction;
+    units_header header{};
+    std::memcpy(header.magic, header_magic, sizeof header.magic);
+    header.version = header_version;
+    header.rep_code = rep_code<typename unit::rep>::value;
+    header.byte_order = native_byte_order;
+    header.unit_identity = units_identity<unit>::value;
+    header.tag_identity = units_tag_identity<typename unit::units_tag>::value;
+    header.num = fraction::num;
+    header.den = fraction::den;
+    header.count = count;
+    return header;
+}
+
+} // namespace detail
+
+// Bytes needed to serialize count values of unit
+template <typename unit>
+constexpr std::size_t serialized_size(std::size_t count) noexcept {
+    return units_header_size + count * sizeof(typename unit::rep);
+}
+
+struct serialize_result {
+    std::size_t size;
+    std::errc ec;
+};
+
+// Serialize values into buffer, failing with std::errc::value_too_large if
+// it is smaller than serialized_size
+template <typename unit>
+serialize_result serialize(quantity_span<unit> values, void *buffer,
+                           std::size_t size) noexcept {
+    using value_type = typename quantity_span<unit>::value_type;
+    using rep = typename value_type::rep;
+    const std::size_t bytes = serialized_size<value_type>(values.size());
+    if (size < bytes) {
+        return {0, std::errc::value_too_large};
+    }
+    const units_header header = detail::make_header<value_type>(values.size());
+    char *out = static_cast<char*>(buffer);
+    std::memcpy(out, &header, sizeof header);
+    std::memset(out + sizeof header, 0, units_header_size - sizeof header);
+    if (!values.empty()) {
+        std::memcpy(out + units_header_size, values.raw_data(),
+                    values.size() * sizeof(rep));
+    }
+    return {bytes, std::errc()};
+}
+
+// Read and validate the header of serialized units. Fails with
+// std::errc::message_size if the buffer is shorter than the header says,
+// and std::errc::invalid_argument if it is not serialized units from a
+// machine of the same byte order.
+inline std::errc read_units_header(const void *buffer, std::size_t size,
+                                   units_header &header) noexcept {
+    if (size < units_header_size) {
+        return std::errc::message_size;
+    }
+    std::memcpy(&header, buffer, sizeof header);
+    if (std::memcmp(header.magic, detail::header_magic, sizeof header.magic) != 0 ||
+        header.version != detail::header_version ||
+        header.byte_order != detail::native_byte_order ||
+        header.num <= 0 || header.den <= 0) {
+        return std::errc::invalid_argument;
+    }
+    const std::size_t rep_size = header.rep_code & 0x0f;
+    if (rep_size == 0 ||
+        header.count > (size - units_header_size) / rep_size) {
+        return std::errc::message_size;
+    }
+    return std::errc();
+}
+
+template <typename unit>
+struct view_result {
+    quantity_span<const unit> values;
+    std::errc ec;
+};
+
+// View serialized units in place without copying. Besides the header
+// errors, fails with std::errc::wrong_protocol_type if the unit or rep
+// differ from unit, and std::errc::bad_address if the payload is not
+// aligned for the rep; load_units handles both.
+template <typename unit>
+view_result<unit> view_units(const void *buffer, std::size_t size) noexcept {
+    using rep = typename unit::rep;
+    units_header header;
+    const std::errc ec = read_units_header(buffer, size, header);
+    if (ec != std::errc()) {
+        return {quantity_span<const unit>(), ec};
+    }
+    if (header.unit_identity != units_identity<unit>::value ||
+        header.rep_code != detail::rep_code<rep>::value) {
+        return {quantity_span<const unit>(), std::errc::wrong_protocol_type};
+    }
+    const char *payload = static_cast<const char*>(buffer) + units_header_size;
+    if (reinterpret_cast<std::uintptr_t>(payload) % alignof(rep) != 0) {
+        return {quantity_span<const unit>(), std::errc::bad_address};
+    }
+    return {quantity_span<const unit>(reinterpret_cast<const rep*>(payload),
+                                      static_cast<std::size_t>(header.count)),
+            std::errc()};
+}
+
+struct load_result {
+    std::size_t count;
+    std::errc ec;
+};
+
+// Copy serialized units into out, converting them in bulk if they were
+// written in another unit of the same dimension. Besides the header errors,
+// fails with std::errc::wrong_protocol_type if the dimension or rep differ,
+// std::errc::invalid_argument if the conversion factor from the header's
+// unit cannot be represented, std::errc::result_out_of_range if a converted
+// value does not fit the rep (it is saturated), and
+// std::errc::value_too_large if out is full before the payload ends.
+template <typename unit>
+load_result load_units(const void *buffer, std::size_t size,
+                       quantity_span<unit> out) noexcept {
+    using rep = typename unit::rep;
+    using fraction = typename unit::fraction;
+    using detail::wide_int;
+    units_header header;
+    const std::errc ec = read_units_header(buffer, size, header);
+    if (ec != std::errc()) {
+        return {0, ec};
+    }
+    if (header.tag_identity != units_tag_identity<typename unit::units_tag>::value ||
+        header.rep_code != detail::rep_code<rep>::value) {
+        return {0, std::errc::wrong_protocol_type};
+    }
+
+    // Factor from the header's unit into unit, reduced as it is formed
+    const bool convert = header.num != fraction::num || header.den != fraction::den;
+    const wide_int g1 = detail::wide_gcd(header.num, fraction::num);
+    const wide_int g2 = detail::wide_gcd(header.den, fraction::den);
+    const wide_int num1 = header.num / g1;
+    const wide_int num2 = fraction::den / g2;
+    const wide_int den1 = header.den / g2;
+    const wide_int den2 = fraction::num / g1;
+    if (num1 > detail::wide_int_max / num2 || den1 > detail::wide_int_max / den2) {
+        return {0, std::errc::invalid_argument};
+    }
+    const wide_int g = detail::wide_gcd(num1 * num2, den1 * den2);
+    const wide_int num = num1 * num2 / g;
+    const wide_int den = den1 * den2 / g;
+    if (!detail::rescale_fits<rep>(num, std::is_floating_point<rep>())) {
+        return {0, std::errc::invalid_argument};
+    }
+
+    const std::size_t n = std::min(static_cast<std::size_t>(header.count),
+                                   out.size());
+    if (n != 0) {
+        std::memcpy(out.raw_data(),
+                    static_cast<const char*>(buffer) + units_header_size,
+                    n * sizeof(rep));
+    }
+    if (convert && !detail::rescale_n(out.raw_data(), n, out.raw_data(), num,
+                                      den, std::is_floating_point<rep>())) {
+        return {n, std::errc::result_out_of_range};
+    }
+    return {n, n < header.count ? std::errc::value_too_large : std::errc()};
+}
+
+} // namespace units
+
+#endif//UNITS_SERIALIZE_H
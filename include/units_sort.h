@@ -0,0 +1,141 @@
+#ifndef UNITS_SORT_H
+#define UNITS_SORT_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+// Units
+#include "quantity_array.h"
+#include "units.h"
+
+namespace units {
+
+// Ranges shorter than this sort with std::sort instead
+constexpr std::size_t radix_sort_threshold = 1024;
+
+namespace detail {
+
+// Unsigned key of a rep whose order as an unsigned integer is the order of
+// the rep: the sign bit flipped for signed integers, and for floating
+// point the sign bit flipped on positives and every bit on negatives
+template <typename rep, typename = void>
+struct radix_key;
+
+template <typename rep>
+struct radix_key<rep, typename std::enable_if<std::is_integral<rep>::value>::type> {
+    using type = typename std::make_unsigned<rep>::type;
+    static constexpr type sign = std::is_signed<rep>::value ?
+        type(type(1) << (sizeof(rep) * 8 - 1)) : type(0);
+
+    static type to(rep v) noexcept { return static_cast<type>(v) ^ sign; }
+    static rep from(type k) noexcept { return static_cast<rep>(k ^ sign); }
+};
+
+template <typename rep>
+struct radix_key<rep, typename std::enable_if<std::is_floating_point<rep>::value>::type> {
+    static_assert(std::numeric_limits<rep>::is_iec559 &&
+                  (sizeof(rep) == 4 || sizeof(rep) == 8),
+                  "radix_sort supports IEEE single and double precision");
+
+    using type = typename std::conditional<sizeof(rep) == 4,
+                                           std::uint32_t, std::uint64_t>::type;
+    static constexpr type sign = type(type(1) << (sizeof(rep) * 8 - 1));
+
+    static type to(rep v) noexcept {
+        type bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        return bits ^ ((bits & sign) ? type(~type(0)) : sign);
+    }
+
+    static rep from(type k) noexcept {
+        const type bits = k ^ ((k & sign) ? sign : type(~type(0)));
+        rep v;
+        std::memcpy(&v, &bits, sizeof v);
+        return v;
+    }
+};
+
+constexpr std::size_t radix_bits = 11;
+constexpr std::size_t radix_buckets = std::size_t(1) << radix_bits;
+
+// Least significant digit first radix sort of keys. The histograms of
+// every digit are counted in one pass, and digits every key shares are
+// skipped. Returns whichever of keys and scratch holds the result.
+template <typename key>
+key* radix_sort_keys(key *keys, key *scratch, std::size_t n) {
+    constexpr std::size_t digits = (sizeof(key) * 8 + radix_bits - 1) / radix_bits;
+    std::vector<std::size_t> counts(digits * radix_buckets, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const key k = keys[i];
+        for (std::size_t d = 0; d < digits; ++d) {
+            ++counts[d * radix_buckets +
+                     ((k >> (d * radix_bits)) & (radix_buckets - 1))];
+        }
+    }
+
+    key *in = keys;
+    key *out = scratch;
+    for (std::size_t d = 0; d < digits; ++d) {
+        std::size_t *count = &counts[d * radix_buckets];
+        const std::size_t shift = d * radix_bits;
+        if (count[(in[0] >> shift) & (radix_buckets - 1)] == n) {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < radix_buckets; ++b) {
+            const std::size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const key k = in[i];
+            out[count[(k >> shift) & (radix_buckets - 1)]++] = k;
+        }
+        std::swap(in, out);
+    }
+    return in;
+}
+
+} // namespace detail
+
+// Sort a range of units in ascending order by radix on the bit patterns of
+// their amounts, which for integral and IEEE floating point reps order
+// exactly as the amounts. Takes two scratch buffers the size of the range.
+// Zeros sort negative before positive, and NaNs sort by sign to either end.
+template <typename unit>
+void radix_sort(quantity_span<unit> values) {
+    static_assert(!std::is_const<unit>::value,
+                  "cannot sort read-only quantities");
+    using rep = typename unit::rep;
+    static_assert(std::is_arithmetic<rep>::value,
+                  "radix_sort needs an integral or floating point rep");
+    using radix = detail::radix_key<rep>;
+    using key = typename radix::type;
+
+    rep *x = values.raw_data();
+    const std::size_t n = values.size();
+    if (n < radix_sort_threshold) {
+        std::sort(x, x + n, [](rep a, rep b) {
+            return radix::to(a) < radix::to(b);
+        });
+        return;
+    }
+
+    std::vector<key> keys(n), scratch(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = radix::to(x[i]);
+    }
+    const key *sorted = detail::radix_sort_keys(keys.data(), scratch.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = radix::from(sorted[i]);
+    }
+}
+
+} // namespace units
+
+#endif//UNITS_SORT_H
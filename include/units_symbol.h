@@ -0,0 +1,111 @@
+#ifndef UNITS_SYMBOL_H
+#define UNITS_SYMBOL_H
+
+// STL
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+// Units
+#include "units_fwd.h"
+
+namespace units {
+
+// A unit symbol and the fraction of the unit it names
+struct symbol_entry {
+    const char *symbol;
+    std::intmax_t num;
+    std::intmax_t den;
+};
+
+// Symbols known for a units tag, as a static constexpr symbol_entry table[].
+// Specialized next to the aliases, with the canonical symbol of each fraction
+// listed before any alternate spellings.
+template <typename units_tag>
+struct units_symbols;
+
+namespace detail {
+
+constexpr std::size_t symbol_length(const char *s) {
+    std::size_t n = 0;
+    while (s[n] != '\0') {
+        ++n;
+    }
+    return n;
+}
+
+constexpr bool symbol_equal(const char *s, std::size_t n, const char *symbol) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (symbol[i] != s[i]) {
+            return false;
+        }
+    }
+    return symbol[n] == '\0';
+}
+
+// FNV-1a with the offset basis replaced by a seed
+constexpr std::uint32_t symbol_hash(const char *s, std::size_t n,
+                                    std::uint32_t seed) {
+    std::uint32_t h = seed;
+    for (std::size_t i = 0; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+    }
+    return h;
+}
+
+// Perfect hash over the symbols of a units tag. The seed is searched for at
+// compile time, so a lookup is one hash, one probe and one comparison.
+template <typename units_tag>
+struct symbol_index {
+    using symbols = units_symbols<units_tag>;
+    static constexpr std::size_t size = std::size(symbols::table);
+    static constexpr std::size_t buckets = 128;
+    static_assert(size < buckets, "too many symbols for the symbol index");
+
+    using slots_type = std::array<std::int8_t, buckets>;
+
+    static constexpr bool build(std::uint32_t seed, slots_type &slots) {
+        for (auto &slot : slots) {
+            slot = -1;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            const char *s = symbols::table[i].symbol;
+            auto &slot = slots[symbol_hash(s, symbol_length(s), seed) % buckets];
+            if (slot != -1) {
+                return false;
+            }
+            slot = static_cast<std::int8_t>(i);
+        }
+        return true;
+    }
+
+    static constexpr std::uint32_t find_seed() {
+        slots_type slots{};
+        std::uint32_t seed = 2166136261u;
+        while (!build(seed, slots)) {
+            ++seed;
+        }
+        return seed;
+    }
+
+    static constexpr slots_type make_slots() {
+        slots_type slots{};
+        build(seed, slots);
+        return slots;
+    }
+
+    static constexpr std::uint32_t seed = find_seed();
+    static constexpr slots_type slots = make_slots();
+
+    // Index into symbols::table of the symbol s[0, n), or -1
+    static constexpr int find(const char *s, std::size_t n) noexcept {
+        const int i = slots[symbol_hash(s, n, seed) % buckets];
+        return i >= 0 && symbol_equal(s, n, symbols::table[i].symbol) ? i : -1;
+    }
+};
+
+} // namespace detail
+
+} // namespace units
+
+#endif//UNITS_SYMBOL_H
@@ -0,0 +1,219 @@
+#ifndef UNITS_TABLE_H
+#define UNITS_TABLE_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <ratio>
+#include <type_traits>
+#include <vector>
+// Units
+#include "detail/units_cast_policy_impl.h"
+#include "detail/units_table_impl.h"
+#include "quantity_array.h"
+#include "units.h"
+
+namespace units {
+
+// Lookup tables mapping one quantity to another by linear interpolation,
+// such as a sensor reading in millimeters to a load in kilograms. Keys in
+// any unit of the key dimension are accepted, and their conversion factor
+// is folded into the table's own scale rather than applied per key. Keys
+// outside the table take the value at its nearest end. A table with one
+// point is constant, and an empty table evaluates to zero.
+//
+// Keys and values share one floating point rep. Batch evaluation of float
+// tables runs eight keys at a time where the CPU has AVX2 and FMA.
+
+namespace detail {
+
+template <typename key_unit, typename value_unit>
+struct check_table_units {
+    static_assert(std::is_same<typename key_unit::rep,
+                               typename value_unit::rep>::value &&
+                  std::is_floating_point<typename key_unit::rep>::value,
+                  "lookup tables need one floating point rep for keys and values");
+    using rep = typename key_unit::rep;
+};
+
+// Factor from keys in unit into keys in key_unit. Single keys of any rep
+// convert to the table's rep; ranges of keys must have it already.
+template <typename unit, typename key_unit>
+struct table_key_factor {
+    using from = typename std::remove_const<unit>::type;
+    static_assert(std::is_same<typename from::units_tag,
+                               typename key_unit::units_tag>::value,
+                  "keys must have the dimension of the table's axis");
+    static constexpr typename key_unit::rep value =
+        units_scale<typename key_unit::rep,
+                    std::ratio_divide<typename from::fraction,
+                                      typename key_unit::fraction> >::value;
+};
+
+template <typename unit, typename key_unit>
+constexpr typename key_unit::rep table_key_factor<unit, key_unit>::value;
+
+} // namespace detail
+
+// Values at evenly spaced keys: first, first + step, first + 2 step...
+// Finding the segment of a key is one multiply and add.
+template <typename key_unit, typename value_unit>
+class uniform_table {
+public:
+    using key_type = key_unit;
+    using value_type = value_unit;
+    using rep = typename detail::check_table_units<key_unit, value_unit>::rep;
+
+    uniform_table() : uniform_table(key_unit(0), key_unit(1), {}) {}
+
+    // A zero step has every key in the first segment
+    template <typename rep1, typename frac1, typename rep2, typename frac2>
+    uniform_table(const units<rep1, frac1, typename key_unit::units_tag> &first,
+                  const units<rep2, frac2, typename key_unit::units_tag> &step,
+                  const std::vector<value_unit> &values)
+        : first_(units_cast<key_unit>(first)),
+          step_(units_cast<key_unit>(step)),
+          size_(values.size()) {
+        const rep s = step_.amount();
+        scale_ = s != rep(0) ? rep(1) / s : rep(0);
+        offset_ = s != rep(0) ? -first_.amount() / s : rep(0);
+        for (const value_unit &v : values) {
+            values_.push_back(v.amount());
+        }
+        values_.resize(std::max<std::size_t>(values_.size(), 1), rep(0));
+        if (values_.size() == 1) {
+            values_.push_back(values_.front());
+        }
+        for (std::size_t i = 0; i + 1 < values_.size(); ++i) {
+            slopes_.push_back(values_[i + 1] - values_[i]);
+        }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    key_unit first() const noexcept { return first_; }
+    key_unit step() const noexcept { return step_; }
+
+    template <typename rep2, typename frac2>
+    value_unit operator()(
+        const units<rep2, frac2, typename key_unit::units_tag> &key) const noexcept {
+        using factor = detail::table_key_factor<
+            units<rep2, frac2, typename key_unit::units_tag>, key_unit>;
+        return value_unit(detail::uniform_lookup(grid(), scale_ * factor::value,
+                                                 static_cast<rep>(key.amount())));
+    }
+
+    // Look up count keys in the table's key unit
+    void evaluate_n(const rep *in, std::size_t count, rep *out) const {
+        detail::uniform_lookup_n(grid(), rep(1), in, count, out);
+    }
+
+    // Look up keys in any unit of the axis. Converts as many keys as both
+    // spans hold, and returns that count. out may alias in.
+    template <typename unit>
+    std::size_t evaluate(quantity_span<unit> in,
+                         quantity_span<value_unit> out) const {
+        static_assert(std::is_same<typename std::remove_const<unit>::type::rep,
+                                   rep>::value,
+                      "keys must have the rep of the table");
+        const std::size_t n = std::min(in.size(), out.size());
+        detail::uniform_lookup_n(grid(), detail::table_key_factor<unit, key_unit>::value,
+                                 in.raw_data(), n, out.raw_data());
+        return n;
+    }
+
+private:
+    detail::uniform_grid<rep> grid() const noexcept {
+        return {values_.data(), slopes_.data(), values_.size(), scale_, offset_};
+    }
+
+    key_unit first_;
+    key_unit step_;
+    std::size_t size_;
+    rep scale_;
+    rep offset_;
+    std::vector<rep> values_;
+    std::vector<rep> slopes_;
+};
+
+// Values at ascending breakpoints, which may be unevenly spaced. Finding the
+// segment of a key is a binary search over the breakpoints.
+template <typename key_unit, typename value_unit>
+class piecewise_table {
+public:
+    using key_type = key_unit;
+    using value_type = value_unit;
+    using rep = typename detail::check_table_units<key_unit, value_unit>::rep;
+
+    piecewise_table() : piecewise_table(std::vector<key_unit>(), {}) {}
+
+    // Breakpoints are converted to key_unit once here. Keys and values of
+    // different lengths use their common length; repeated breakpoints make
+    // a step, taking the later value.
+    template <typename unit>
+    piecewise_table(const std::vector<unit> &keys,
+                    const std::vector<value_unit> &values)
+        : size_(std::min(keys.size(), values.size())) {
+        for (std::size_t i = 0; i < size_; ++i) {
+            keys_.push_back(units_cast<key_unit>(keys[i]).amount());
+            values_.push_back(values[i].amount());
+        }
+        keys_.resize(std::max<std::size_t>(size_, 1), rep(0));
+        values_.resize(std::max<std::size_t>(size_, 1), rep(0));
+        if (keys_.size() == 1) {
+            keys_.push_back(keys_.front());
+            values_.push_back(values_.front());
+        }
+        for (std::size_t i = 0; i + 1 < keys_.size(); ++i) {
+            const rep dx = keys_[i + 1] - keys_[i];
+            slopes_.push_back(dx > rep(0) ? (values_[i + 1] - values_[i]) / dx
+                                          : rep(0));
+        }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    key_unit key(std::size_t i) const noexcept { return key_unit(keys_[i]); }
+    value_unit value(std::size_t i) const noexcept {
+        return value_unit(values_[i]);
+    }
+
+    template <typename rep2, typename frac2>
+    value_unit operator()(
+        const units<rep2, frac2, typename key_unit::units_tag> &key) const noexcept {
+        using factor = detail::table_key_factor<
+            units<rep2, frac2, typename key_unit::units_tag>, key_unit>;
+        return value_unit(detail::piecewise_lookup(
+            grid(), static_cast<rep>(key.amount()) * factor::value));
+    }
+
+    // Look up count keys in the table's key unit
+    void evaluate_n(const rep *in, std::size_t count, rep *out) const {
+        detail::piecewise_lookup_n(grid(), rep(1), in, count, out);
+    }
+
+    // Look up keys in any unit of the axis, as uniform_table::evaluate
+    template <typename unit>
+    std::size_t evaluate(quantity_span<unit> in,
+                         quantity_span<value_unit> out) const {
+        static_assert(std::is_same<typename std::remove_const<unit>::type::rep,
+                                   rep>::value,
+                      "keys must have the rep of the table");
+        const std::size_t n = std::min(in.size(), out.size());
+        detail::piecewise_lookup_n(grid(), detail::table_key_factor<unit, key_unit>::value,
+                                   in.raw_data(), n, out.raw_data());
+        return n;
+    }
+
+private:
+    detail::piecewise_grid<rep> grid() const noexcept {
+        return {keys_.data(), values_.data(), slopes_.data(), keys_.size()};
+    }
+
+    std::size_t size_;
+    std::vector<rep> keys_;
+    std::vector<rep> values_;
+    std::vector<rep> slopes_;
+};
+
+} // namespace units
+
+#endif//UNITS_TABLE_H
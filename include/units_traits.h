@@ -8,6 +8,27 @@
 
 namespace units {
 
+// Reps which convert like floating point, so that any conversion between
+// them is allowed. Specialized for storage reps that compute in floating
+// point, as std::chrono::treat_as_floating_point.
+template <typename rep>
+struct treat_as_floating_point : std::is_floating_point<rep> {};
+
+// Type a rep computes in: the rep itself, except for compact storage reps
+template <typename rep>
+struct compute_rep {
+    using type = rep;
+};
+
+namespace detail {
+
+// Type the arithmetic between two reps is done in
+template <typename rep1, typename rep2>
+using common_rep = typename std::common_type<
+    typename compute_rep<rep1>::type, typename compute_rep<rep2>::type>::type;
+
+} // namespace detail
+
 // Check if something is a unit type
 template <typename T>
 struct is_unit : std::false_type {};
@@ -24,10 +45,11 @@ template <typename rep1, typename fraction1,
           typename rep2, typename fraction2, typename units_tag>
 struct is_unit_convertible<units<rep1, fraction1, units_tag>,
                            units<rep2, fraction2, units_tag> > : std::true_type {
-    static_assert(std::is_convertible<rep1, rep2>::value,
+    static_assert(std::is_convertible<typename compute_rep<rep1>::type,
+                                      rep2>::value,
                   "unit reps must be convertible");
-    static_assert(std::is_floating_point<rep1>::value ||
-                  !std::is_floating_point<rep2>::value,
+    static_assert(treat_as_floating_point<rep1>::value ||
+                  !treat_as_floating_point<rep2>::value,
                   "cannot mix floating and integral types in unit conversion");
 };
 
@@ -4,12 +4,12 @@
 // STL
 #include <ratio>
 // Units
+#include "dimension.h"
 #include "units.h"
+#include "units_symbol.h"
 
 namespace units {
 
-inline namespace weight {
-
 namespace detail {
 
 struct weight_tag {};
@@ -19,44 +19,76 @@ using weight = units<rep_, fraction_, weight_tag>;
 
 } // namespace detail
 
+template <>
+struct dimension_of<detail::weight_tag> {
+    using type = detail::dimension<0, 1, 0>;
+};
+
+template <>
+struct dimension_tag<detail::dimension<0, 1, 0> > {
+    using type = detail::weight_tag;
+};
+
+inline namespace weight {
+
+// Fractions are in ounces, reduced ahead of time so that naming a unit does
+// not instantiate a chain of std::ratio_multiply
 template <typename rep>
 using ounces = detail::weight<rep, std::ratio<1> >;
+// 16 ounces
 template <typename rep>
-using pounds = detail::weight<
-    rep, std::ratio_multiply<std::ratio<16>,
-                             typename ounces<rep>::fraction> >;
+using pounds = detail::weight<rep, std::ratio<16> >;
+// 14 pounds
 template <typename rep>
-using stones = detail::weight<
-    rep, std::ratio_multiply<std::ratio<14>,
-                             typename pounds<rep>::fraction> >;
+using stones = detail::weight<rep, std::ratio<224> >;
+// 2000 pounds
 template <typename rep>
-using short_tons = detail::weight<
-    rep, std::ratio_multiply<std::ratio<2000>,
-                             typename pounds<rep>::fraction> >;
+using short_tons = detail::weight<rep, std::ratio<32000> >;
+// 2240 pounds
 template <typename rep>
-using long_tons = detail::weight<
-    rep, std::ratio_multiply<std::ratio<2240>,
-                             typename pounds<rep>::fraction> >;
-
+using long_tons = detail::weight<rep, std::ratio<35840> >;
+// 10000 / 283495 ounces
 template <typename rep>
-using grams = detail::weight<
-    rep, std::ratio_multiply<std::ratio<10000, 283495>,
-                             typename ounces<rep>::fraction> >;
+using grams = detail::weight<rep, std::ratio<2000, 56699> >;
+// 1 / 1000000 grams
 template <typename rep>
-using micrograms = detail::weight<
-    rep, std::ratio_multiply<std::micro,
-                             typename grams<rep>::fraction> >;
+using micrograms = detail::weight<rep, std::ratio<1, 28349500> >;
+// 1000 grams
 template <typename rep>
-using kilograms = detail::weight<
-    rep, std::ratio_multiply<std::kilo,
-                             typename grams<rep>::fraction> >;
+using kilograms = detail::weight<rep, std::ratio<2000000, 56699> >;
+// 1000000 grams
 template <typename rep>
-using metric_tons = detail::weight<
-    rep, std::ratio_multiply<std::mega,
-                             typename grams<rep>::fraction> >;
+using metric_tons = detail::weight<rep, std::ratio<2000000000, 56699> >;
 
 } // namespace weight
 
+// Unit symbols, canonical symbol first
+template <>
+struct units_symbols<detail::weight_tag> {
+    static constexpr symbol_entry table[] = {
+        {"oz", ounces<int>::fraction::num,
+         ounces<int>::fraction::den},
+        {"lb", pounds<int>::fraction::num,
+         pounds<int>::fraction::den},
+        {"st", stones<int>::fraction::num,
+         stones<int>::fraction::den},
+        {"ton", short_tons<int>::fraction::num,
+         short_tons<int>::fraction::den},
+        {"LT", long_tons<int>::fraction::num,
+         long_tons<int>::fraction::den},
+        {"g", grams<int>::fraction::num,
+         grams<int>::fraction::den},
+        {"ug", micrograms<int>::fraction::num,
+         micrograms<int>::fraction::den},
+        {"\u00b5g", micrograms<int>::fraction::num,
+         micrograms<int>::fraction::den},
+        {"kg", kilograms<int>::fraction::num,
+         kilograms<int>::fraction::den},
+        {"t", metric_tons<int>::fraction::num,
+         metric_tons<int>::fraction::den},
+    };
+};
+
 } // namespace units
 
 #endif//WEIGHT_H
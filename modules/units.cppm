@@ -0,0 +1,227 @@
+// C++20 module interface for the units library. The headers remain the
+// primary interface; this unit includes them in its global module fragment
+// and exports their public names, so importers parse them once.
+// GCC 12 cannot compile it (an internal compiler error in module
+// streaming), so the UNITS_MODULE build option needs GCC 13 or newer.
+module;
+
+#include "compact_rep.h"
+#include "distance.h"
+#include "duration.h"
+#include "quantity_array.h"
+#include "temperature.h"
+#include "units_atomic.h"
+#include "units_bounded.h"
+#include "units.h"
+#include "units_cast.h"
+#include "units_cast_n.h"
+#include "units_chrono.h"
+#include "units_expr.h"
+#include "units_format.h"
+#include "units_hash.h"
+#include "units_identity.h"
+#include "units_instrument.h"
+#include "units_pack.h"
+#include "units_pair.h"
+#include "units_point.h"
+#include "units_parse.h"
+#include "units_reduce.h"
+#include "units_runtime.h"
+#include "units_serialize.h"
+#include "units_sort.h"
+#include "units_symbol.h"
+#include "units_table.h"
+#include "weight.h"
+
+export module units;
+
+export namespace units {
+
+// units.h
+using ::units::units;
+using ::units::operator==;
+using ::units::operator!=;
+using ::units::operator<;
+using ::units::operator<=;
+using ::units::operator>;
+using ::units::operator>=;
+using ::units::operator+;
+using ::units::operator-;
+using ::units::operator*;
+using ::units::operator/;
+
+// units_traits.h, dimension.h
+using ::units::is_unit;
+using ::units::is_unit_convertible;
+using ::units::dimension_of;
+using ::units::dimension_tag;
+using ::units::units_multiply;
+using ::units::units_divide;
+using ::units::treat_as_floating_point;
+using ::units::compute_rep;
+
+// units_cast.h, units_cast_policy.h
+using ::units::units_cast;
+using ::units::is_cast_policy;
+using ::units::floor;
+using ::units::ceil;
+using ::units::round;
+
+namespace cast_policy {
+using ::units::cast_policy::automatic;
+using ::units::cast_policy::fused;
+using ::units::cast_policy::exact;
+using ::units::cast_policy::saturating;
+using ::units::cast_policy::rounded;
+} // namespace cast_policy
+
+namespace rounding {
+using ::units::rounding::truncate;
+using ::units::rounding::nearest;
+using ::units::rounding::floor;
+using ::units::rounding::ceil;
+} // namespace rounding
+
+// units_chrono.h
+using ::units::from_chrono;
+using ::units::to_chrono;
+
+// units_pair.h
+using ::units::units_pair;
+
+// units_point.h
+using ::units::units_point;
+using ::units::is_units_point;
+using ::units::units_point_cast;
+using ::units::units_point_cast_n;
+
+// units_cast_n.h, quantity_array.h
+using ::units::units_cast_n;
+using ::units::units_cast_in_place;
+using ::units::quantity_alignment;
+using ::units::quantity_span;
+using ::units::quantity_array;
+
+// units_symbol.h, units_parse.h, units_format.h
+using ::units::symbol_entry;
+using ::units::units_symbols;
+using ::units::units_symbol;
+using ::units::from_chars;
+using ::units::parse_result;
+using ::units::parse;
+using ::units::parse_n_result;
+using ::units::parse_n;
+using ::units::to_chars;
+
+// units_identity.h, units_serialize.h
+using ::units::units_tag_identity;
+using ::units::units_identity;
+using ::units::units_header;
+using ::units::units_header_size;
+using ::units::serialized_size;
+using ::units::serialize_result;
+using ::units::serialize;
+using ::units::read_units_header;
+using ::units::view_result;
+using ::units::view_units;
+using ::units::load_result;
+using ::units::load_units;
+
+// compact_rep.h, units_pack.h
+using ::units::float16;
+using ::units::bfloat16;
+using ::units::fixed_point;
+using ::units::pack_n;
+using ::units::unpack_n;
+
+// units_runtime.h
+using ::units::unit_id;
+using ::units::unit_id_count;
+using ::units::find_unit_id;
+using ::units::unit_id_of;
+using ::units::unit_id_symbol;
+using ::units::unit_id_factor;
+
+// units_expr.h
+using ::units::expr_unit;
+using ::units::evaluate;
+
+// units_sort.h
+using ::units::radix_sort_threshold;
+using ::units::radix_sort;
+
+// units_table.h
+using ::units::uniform_table;
+using ::units::piecewise_table;
+
+// units_bounded.h
+using ::units::bounded_units;
+using ::units::is_bounded_units;
+using ::units::bounded_result;
+using ::units::make_bounded;
+
+// units_atomic.h
+using ::units::atomic_units;
+using ::units::sharded_units;
+
+// units_instrument.h
+using ::units::conversion_count;
+using ::units::conversion_report;
+using ::units::conversions_dropped;
+using ::units::reset_conversion_counts;
+using ::units::print_conversion_report;
+
+// units_reduce.h
+using ::units::parallel_reduce_grain;
+using ::units::sum;
+using ::units::mean;
+using ::units::minimum;
+using ::units::maximum;
+using ::units::dot;
+
+namespace distance {
+using ::units::distance::inches;
+using ::units::distance::feet;
+using ::units::distance::yards;
+using ::units::distance::miles;
+using ::units::distance::nautical_miles;
+using ::units::distance::meters;
+using ::units::distance::micrometers;
+using ::units::distance::millimeters;
+using ::units::distance::centimeters;
+using ::units::distance::kilometers;
+} // namespace distance
+
+namespace weight {
+using ::units::weight::ounces;
+using ::units::weight::pounds;
+using ::units::weight::stones;
+using ::units::weight::short_tons;
+using ::units::weight::long_tons;
+using ::units::weight::grams;
+using ::units::weight::micrograms;
+using ::units::weight::kilograms;
+using ::units::weight::metric_tons;
+} // namespace weight
+
+namespace duration {
+using ::units::duration::seconds;
+using ::units::duration::nanoseconds;
+using ::units::duration::microseconds;
+using ::units::duration::milliseconds;
+using ::units::duration::minutes;
+using ::units::duration::hours;
+} // namespace duration
+
+namespace temperature {
+using ::units::temperature::kelvin;
+using ::units::temperature::celsius;
+using ::units::temperature::rankine;
+using ::units::temperature::fahrenheit;
+using ::units::temperature::kelvin_point;
+using ::units::temperature::celsius_point;
+using ::units::temperature::rankine_point;
+using ::units::temperature::fahrenheit_point;
+} // namespace temperature
+
+} // namespace units
@@ -1,7 +1,39 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+#include "compact_rep.h"
 #include "distance.h"
+#include "duration.h"
+#include "quantity_array.h"
+#include "temperature.h"
+#include "units_atomic.h"
+#include "units_bounded.h"
+#include "units_cast_n.h"
+#include "units_chrono.h"
+#include "units_expr.h"
+#include "units_format.h"
+#include "units_hash.h"
+#include "units_instrument.h"
+#include "units_parse.h"
+#include "units_pack.h"
 #include "units_pair.h"
+#include "units_point.h"
+#include "units_reduce.h"
+#include "units_runtime.h"
+#include "units_serialize.h"
+#include "units_sort.h"
+#include "units_table.h"
 #include "weight.h"
 
 TEST(UnitsTest, UnitsOperators) {
@@ -136,3 +168,1375 @@ TEST(UnitsTest, UnitsPairOperators) {
     EXPECT_EQ((stones_per_inch{15.f, std::divides<float>()}), stones_per_inch{si1} += si2);
     EXPECT_EQ((stones_per_inch{5.f, std::divides<float>()}), stones_per_inch{si1} -= si2);
 }
+
+TEST(UnitsTest, UnitsPairLayout) {
+    using stones = units::stones<float>;
+    using inches = units::inches<float>;
+    using stones_per_inch =
+        units::units_pair<stones, inches, std::divides<float> >;
+    static_assert(sizeof(stones_per_inch) == sizeof(float),
+                  "units_pair must be the size of its rep");
+    static_assert(std::is_trivially_copyable<stones_per_inch>::value,
+                  "units_pair must be trivially copyable");
+    static_assert(sizeof(units::units_pair<stones, inches>) == sizeof(float) &&
+                  std::is_trivially_copyable<units::units_pair<stones, inches> >::value,
+                  "a units_pair without an operator must be its rep alone");
+    static_assert(std::is_same<decltype(stones{10} / inches{2}),
+                               stones_per_inch::base>::value,
+                  "division must name the same composite unit");
+
+    constexpr stones_per_inch si{stones{10}, inches{2}};
+    static_assert(si.amount() == 5.f, "units_pair must be constexpr");
+    EXPECT_FLOAT_EQ(5.f, si.amount());
+}
+
+TEST(UnitsTest, Dimensions) {
+    using meters = units::meters<double>;
+    using millimeters = units::millimeters<double>;
+    using inches = units::inches<double>;
+    using seconds = units::seconds<double>;
+    using hours = units::hours<double>;
+
+    // Products and quotients chain, and their fraction is merged exactly
+    auto area = meters{2} * meters{3};
+    auto volume = area * millimeters{500};
+    EXPECT_DOUBLE_EQ(3000., volume.amount());
+    using volume_t = decltype(volume);
+    static_assert(std::is_same<volume_t::units_tag,
+                               units::detail::dimension<3, 0, 0> >::value,
+                  "volume must have distance cubed");
+    static_assert(sizeof(volume_t) == sizeof(double),
+                  "composite units must be the size of their rep");
+
+    auto flux = meters{4} * meters{2} / seconds{2};
+    using flux_t = decltype(flux);
+    static_assert(std::is_same<flux_t::fraction,
+                               std::ratio_multiply<meters::fraction,
+                                                   meters::fraction> >::value,
+                  "fraction must be folded at compile time");
+    EXPECT_DOUBLE_EQ(4., flux.amount());
+
+    // A composite that reduces to a base dimension is that base unit
+    inches in = area / meters{2};
+    EXPECT_NEAR(118.11024, in.amount(), 1e-5);
+
+    // Like units cancel to a scalar
+    EXPECT_DOUBLE_EQ(2., area / (meters{1} * meters{3}));
+
+    // Equivalent composites convert
+    using meters_per_second = units::units_divide<meters, seconds>;
+    using millimeters_per_hour = units::units_divide<millimeters, hours>;
+    auto speed = meters{10} / seconds{5};
+    millimeters_per_hour mmh = speed;
+    EXPECT_DOUBLE_EQ(7200000., mmh.amount());
+    EXPECT_DOUBLE_EQ(2., units::units_cast<meters_per_second>(mmh).amount());
+}
+
+TEST(UnitsTest, UnitsCastN) {
+    using millimeters = units::millimeters<float>;
+    using inches = units::inches<float>;
+
+    // Odd length exercises the vector tails
+    std::vector<millimeters> mm;
+    for (int i = 0; i < 1037; ++i) {
+        mm.push_back(millimeters(static_cast<float>(i) * 0.5f));
+    }
+    std::vector<inches> in(mm.size());
+    units::units_cast_n(mm.data(), mm.size(), in.data());
+    for (std::size_t i = 0; i < mm.size(); ++i) {
+        EXPECT_FLOAT_EQ(units::units_cast<inches>(mm[i]).amount(),
+                        in[i].amount());
+    }
+
+    // Raw buffers, converted in place
+    using kilometers = units::kilometers<double>;
+    using nautical_miles = units::nautical_miles<double>;
+    std::vector<double> raw{1., 2., 3., 4., 5.};
+    units::units_cast_in_place<kilometers, nautical_miles>(raw.data(),
+                                                           raw.size());
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        auto nm = nautical_miles(static_cast<double>(i + 1));
+        EXPECT_DOUBLE_EQ(units::units_cast<kilometers>(nm).amount(), raw[i]);
+    }
+
+    // Integer reps take the exact path
+    std::vector<int> ft{1, 2, 3};
+    std::vector<int> inch(ft.size());
+    units::units_cast_n<units::inches<int>, units::feet<int> >(
+        ft.data(), ft.size(), inch.data());
+    EXPECT_EQ(12, inch[0]);
+    EXPECT_EQ(36, inch[2]);
+}
+
+TEST(UnitsTest, QuantityArray) {
+    using millimeters = units::millimeters<float>;
+    using inches = units::inches<float>;
+
+    // View a raw buffer as units without copying
+    float raw[] = {25.4f, 50.8f, 76.2f};
+    units::quantity_span<millimeters> mm(raw, 3);
+    EXPECT_EQ(static_cast<void*>(raw), static_cast<void*>(mm.data()));
+    EXPECT_EQ(millimeters{50.8f}, mm[1]);
+
+    // Convert the view in place
+    auto in = mm.convert_to<inches>();
+    EXPECT_FLOAT_EQ(1.f, raw[0]);
+    EXPECT_FLOAT_EQ(3.f, in[2].amount());
+
+    // Owning arrays are aligned for the SIMD kernels
+    units::quantity_array<inches> arr(100, inches{2});
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(arr.data()) %
+                  units::quantity_alignment);
+
+    auto copied = arr.convert_to<millimeters>();
+    EXPECT_FLOAT_EQ(50.8f, copied[99].amount());
+    EXPECT_EQ(inches{2}, arr[0]);
+
+    const float *storage = arr.raw_data();
+    auto moved = std::move(arr).convert_to<millimeters>();
+    EXPECT_EQ(storage, moved.raw_data());
+    EXPECT_FLOAT_EQ(50.8f, moved[0].amount());
+
+    units::quantity_span<const millimeters> view = moved;
+    units::quantity_array<inches> back(view.size());
+    EXPECT_EQ(view.size(), view.convert_to(back.span()));
+    EXPECT_FLOAT_EQ(2.f, back[42].amount());
+
+    // Spans of different sizes convert their common length
+    units::quantity_array<inches> shorter(10, inches{0});
+    EXPECT_EQ(10u, view.convert_to(shorter.span()));
+    EXPECT_FLOAT_EQ(2.f, shorter[9].amount());
+}
+
+TEST(UnitsTest, UnitsCastPolicy) {
+    namespace policy = units::cast_policy;
+    using millimeters = units::millimeters<float>;
+    using inches = units::inches<float>;
+
+    // Every floating point policy agrees on ordinary values
+    auto mm = millimeters{200};
+    EXPECT_FLOAT_EQ(7.8740158f,
+                    (units::units_cast<inches, policy::fused>(mm).amount()));
+    EXPECT_FLOAT_EQ(7.8740158f,
+                    (units::units_cast<inches, policy::exact>(mm).amount()));
+    EXPECT_FLOAT_EQ(7.8740158f,
+                    (units::units_cast<inches, policy::saturating>(mm).amount()));
+
+    // Integer scaling does not overflow midway through num and den. Without
+    // a 128 bit type, 64 bit reps scale in the common rep as plain casts do.
+    using nautical_miles = units::nautical_miles<std::int64_t>;
+    using meters = units::meters<std::int64_t>;
+#if defined(__SIZEOF_INT128__)
+    constexpr auto big = nautical_miles{std::int64_t(1) << 44};
+    constexpr auto m = units::units_cast<meters>(big);
+    static_assert(m.amount() > 0, "wide intermediate must not overflow");
+#endif
+    EXPECT_EQ(1852, units::units_cast<meters>(nautical_miles{1}).amount());
+
+    // Exact integer casts are proven in range at compile time
+    using micrometers32 = units::micrometers<std::int32_t>;
+    using micrometers64 = units::micrometers<std::int64_t>;
+    using millimeters32 = units::millimeters<std::int32_t>;
+    constexpr auto um = units::units_cast<micrometers64, policy::exact>(
+        millimeters32{-2000000000});
+    static_assert(um.amount() == -2000000000000LL, "exact cast must be exact");
+
+    // Saturating casts clamp to the target range
+    auto clamped = units::units_cast<micrometers32, policy::saturating>(
+        millimeters32{5000000});
+    EXPECT_EQ(std::numeric_limits<std::int32_t>::max(), clamped.amount());
+    auto flt = units::units_cast<units::meters<float>, policy::saturating>(
+        units::kilometers<double>{1e300});
+    EXPECT_EQ(std::numeric_limits<float>::max(), flt.amount());
+}
+
+TEST(UnitsTest, UnitsCastRounding) {
+    using micrometers = units::micrometers<std::int32_t>;
+    using millimeters = units::millimeters<std::int32_t>;
+    using truncated = units::cast_policy::rounded<units::rounding::truncate>;
+
+    static_assert(units::floor<millimeters>(micrometers{-1500}).amount() == -2,
+                  "floor must round toward negative infinity");
+    static_assert(units::ceil<millimeters>(micrometers{-1500}).amount() == -1,
+                  "ceil must round toward positive infinity");
+    EXPECT_EQ(-1, (units::units_cast<millimeters, truncated>(
+                       micrometers{-1999}).amount()));
+
+    // Nearest rounds ties to even
+    EXPECT_EQ(2, units::round<millimeters>(micrometers{1500}).amount());
+    EXPECT_EQ(2, units::round<millimeters>(micrometers{2500}).amount());
+    EXPECT_EQ(3, units::round<millimeters>(micrometers{2501}).amount());
+    EXPECT_EQ(-2, units::round<millimeters>(micrometers{-2500}).amount());
+    EXPECT_EQ(-3, units::round<millimeters>(micrometers{-2501}).amount());
+
+    // Non-integral ratios stay on integers
+    using inches = units::inches<std::int32_t>;
+    EXPECT_EQ(4, units::round<inches>(millimeters{100}).amount());
+    EXPECT_EQ(3, units::floor<inches>(millimeters{100}).amount());
+    EXPECT_EQ(127, units::round<millimeters>(
+                       units::inches<std::int16_t>{5}).amount());
+}
+
+TEST(UnitsTest, Parse) {
+    using millimeters = units::millimeters<double>;
+
+    auto ft = units::parse<millimeters>("3 ft");
+    EXPECT_EQ(std::errc(), ft.ec);
+    EXPECT_DOUBLE_EQ(914.4, ft.value.amount());
+
+    auto nmi = units::parse<units::kilometers<double> >(" 0.2nmi ");
+    EXPECT_EQ(std::errc(), nmi.ec);
+    EXPECT_NEAR(0.3704, nmi.value.amount(), 1e-6);
+
+    auto um = units::parse<millimeters>("12.5 \u00b5m");
+    EXPECT_EQ(std::errc(), um.ec);
+    EXPECT_DOUBLE_EQ(0.0125, um.value.amount());
+
+    auto lb = units::parse<units::grams<float> >("2 lb");
+    EXPECT_EQ(std::errc(), lb.ec);
+    EXPECT_FLOAT_EQ(907.184f, lb.value.amount());
+
+    // Symbols of another dimension or unknown symbols are errors
+    auto wrong = units::parse<millimeters>("3 kg");
+    EXPECT_EQ(std::errc::invalid_argument, wrong.ec);
+    EXPECT_EQ(2u, wrong.offset);
+    EXPECT_EQ(std::errc::invalid_argument,
+              units::parse<millimeters>("3").ec);
+    EXPECT_EQ(std::errc::invalid_argument,
+              units::parse<millimeters>("3 mm x").ec);
+
+    // Integral reps round exactly and check their range
+    using micrometers = units::micrometers<std::int32_t>;
+    EXPECT_EQ(25400, units::parse<micrometers>("1 in").value.amount());
+    EXPECT_EQ(std::errc::result_out_of_range,
+              units::parse<micrometers>("100 km").ec);
+    EXPECT_EQ(std::errc::result_out_of_range,
+              units::parse<units::micrometers<std::int64_t> >(
+                  "9223372036854775807 km").ec);
+    EXPECT_EQ(std::errc::invalid_argument,
+              units::parse<micrometers>("1.5 mm").ec);
+}
+
+TEST(UnitsTest, ParseN) {
+    using millimeters = units::millimeters<float>;
+    units::quantity_array<millimeters> out(4);
+
+    auto r = units::parse_n<millimeters>("1 mm\n2 cm\n 3 in \n", '\n',
+                                         out.span());
+    EXPECT_EQ(std::errc(), r.ec);
+    EXPECT_EQ(3u, r.count);
+    EXPECT_FLOAT_EQ(20.f, out[1].amount());
+    EXPECT_FLOAT_EQ(76.2f, out[2].amount());
+
+    auto bad = units::parse_n<millimeters>("1 mm,2 parsecs,3 mm", ',',
+                                           out.span());
+    EXPECT_EQ(std::errc::invalid_argument, bad.ec);
+    EXPECT_EQ(1u, bad.count);
+    EXPECT_EQ(7u, bad.offset);
+
+    auto full = units::parse_n<millimeters>("1mm\t2mm\t3mm\t4mm\t5mm", '\t',
+                                            out.span());
+    EXPECT_EQ(std::errc::value_too_large, full.ec);
+    EXPECT_EQ(4u, full.count);
+}
+
+TEST(UnitsTest, Format) {
+    char buf[32];
+    auto str = [&buf](std::to_chars_result r) {
+        EXPECT_EQ(std::errc(), r.ec);
+        return std::string(buf, r.ptr);
+    };
+
+    EXPECT_EQ("12.5 mm", str(units::to_chars(buf, buf + sizeof(buf),
+                                             units::millimeters<double>{12.5})));
+    EXPECT_EQ("3 lb", str(units::to_chars(buf, buf + sizeof(buf),
+                                          units::pounds<int>{3})));
+    EXPECT_EQ("0.20 nmi", str(units::to_chars(buf, buf + sizeof(buf),
+                                              units::nautical_miles<float>{0.2f},
+                                              std::chars_format::fixed, 2)));
+    EXPECT_EQ("ff kg", str(units::to_chars(buf, buf + sizeof(buf),
+                                           units::kilograms<int>{255}, 16)));
+
+    // units_pair symbols are composed at compile time
+    using stones_per_inch = units::units_pair<units::stones<float>,
+                                              units::inches<float>,
+                                              std::divides<float> >;
+    static_assert(units::units_symbol<stones_per_inch>::length == 5,
+                  "pair symbol must be st/in");
+    EXPECT_EQ("5 st/in", str(units::to_chars(buf, buf + sizeof(buf),
+                                             stones_per_inch{5.f})));
+
+    // Products and quotients are written with their base unit symbols
+    EXPECT_EQ("5 st/in", str(units::to_chars(buf, buf + sizeof(buf),
+                                             units::stones<float>{10} /
+                                                 units::inches<float>{2})));
+    const auto g = units::meters<double>{9.5} /
+        (units::seconds<double>{1} * units::seconds<double>{1});
+    EXPECT_EQ("9.5 m/s^2", str(units::to_chars(buf, buf + sizeof(buf), g)));
+    EXPECT_EQ("6 ft*lb", str(units::to_chars(buf, buf + sizeof(buf),
+                                             units::feet<int>{2} *
+                                                 units::pounds<int>{3})));
+    EXPECT_EQ("2 1/h", str(units::to_chars(buf, buf + sizeof(buf),
+                                           units::feet<int>{4} /
+                                               (units::feet<int>{2} *
+                                                units::hours<int>{1}))));
+
+    // The symbol has to fit as well as the amount
+    char small[4];
+    EXPECT_EQ(std::errc::value_too_large,
+              units::to_chars(small, small + sizeof(small),
+                              units::millimeters<int>{12}).ec);
+
+#if defined(__cpp_lib_format)
+    EXPECT_EQ("1.50 km", std::format("{:.2f}", units::kilometers<double>{1.5}));
+    EXPECT_EQ("9.5 m/s^2", std::format("{}", g));
+#endif
+}
+
+TEST(UnitsTest, Reduce) {
+    using grams = units::grams<float>;
+    using kilograms = units::kilograms<float>;
+
+    // Enough values to be split across threads, and to lose precision if
+    // summed serially in float
+    const std::size_t n = units::parallel_reduce_grain * 4 + 3;
+    units::quantity_array<grams> g(n, grams{0.1f});
+    g[7] = grams{-5.f};
+    g[n - 1] = grams{12.f};
+
+    const double expected = 0.1f * static_cast<double>(n - 2) - 5. + 12.;
+    EXPECT_FLOAT_EQ(static_cast<float>(expected),
+                    units::sum(g.span()).amount());
+    EXPECT_FLOAT_EQ(static_cast<float>(expected / 1000.),
+                    units::sum<kilograms>(g.span()).amount());
+    EXPECT_FLOAT_EQ(static_cast<float>(expected / static_cast<double>(n)),
+                    units::mean(g.span()).amount());
+    EXPECT_EQ(grams{-5.f}, units::minimum(g.span()));
+    EXPECT_EQ(grams{12.f}, units::maximum(g.span()));
+
+    // Integers reduce exactly
+    units::quantity_array<units::feet<int> > ft(10, units::feet<int>{3});
+    EXPECT_EQ(30, units::sum(ft.span()).amount());
+    EXPECT_EQ(360, units::sum<units::inches<int> >(ft.span()).amount());
+
+    // Dot products land in the composite unit of the product
+    using meters = units::meters<double>;
+    using seconds = units::seconds<double>;
+    units::quantity_array<meters> d(3, meters{2.});
+    units::quantity_array<seconds> t(3, seconds{5.});
+    auto mt = units::dot(d.span(), t.span());
+    static_assert(std::is_same<decltype(mt),
+                               units::units_multiply<meters, seconds> >::value,
+                  "dot must return the product unit");
+    EXPECT_DOUBLE_EQ(30., mt.amount());
+    using millimeter_seconds =
+        units::units_multiply<units::millimeters<double>, seconds>;
+    EXPECT_DOUBLE_EQ(30000., units::dot<millimeter_seconds>(
+                                 d.span(), t.span()).amount());
+
+    units::quantity_array<grams> empty;
+    EXPECT_EQ(grams{0.f}, units::mean(empty.span()));
+}
+
+TEST(UnitsTest, CommonType) {
+    using common = std::common_type<units::inches<int>,
+                                    units::millimeters<long long> >::type;
+    static_assert(std::is_same<common::rep, long long>::value,
+                  "common rep must be the wider rep");
+    static_assert(std::ratio_equal<common::fraction, std::ratio<1, 127> >::value,
+                  "common fraction must divide both fractions");
+
+    // Mixed integral units add, subtract and compare exactly, in fifths of a
+    // millimeter
+    auto sum = units::inches<int>{1} + units::millimeters<long long>{5};
+    static_assert(std::is_same<decltype(sum), common>::value,
+                  "mixed addition must return the common unit");
+    EXPECT_EQ(127 + 25, sum.amount());
+    EXPECT_EQ(127 - 25, (units::inches<int>{1} -
+                        units::millimeters<long long>{5}).amount());
+    // Exact as long as the result fits, though an operand alone would not
+    EXPECT_EQ(2040000000, (units::inches<int>{20000000} +
+                           units::millimeters<int>{-100000000}).amount());
+    EXPECT_EQ(2040000000, (units::inches<int>{20000000} -
+                           units::millimeters<int>{100000000}).amount());
+    static_assert(units::detail::wide_scales<units::inches<int>,
+                                             units::millimeters<int> >::sum_fits,
+                  "32 bit reps always sum in the wide intermediate");
+    static_assert(units::detail::wide_scales<units::inches<std::int64_t>,
+                                             units::millimeters<std::int64_t> >::sum_fits ==
+                  (sizeof(units::detail::wide_int) > sizeof(std::int64_t)),
+                  "64 bit reps need a 128 bit intermediate to sum");
+    EXPECT_EQ(127 + 25, (units::inches<std::int64_t>{1} +
+                         units::millimeters<std::int64_t>{5}).amount());
+    EXPECT_EQ(units::feet<int>{1}, units::inches<int>{12});
+    EXPECT_NE(units::feet<int>{1}, units::inches<int>{13});
+    EXPECT_LT(units::inches<int>{1}, units::millimeters<int>{26});
+    EXPECT_GT(units::inches<int>{1}, units::millimeters<int>{25});
+    EXPECT_LE(units::yards<int>{1}, units::feet<int>{3});
+    EXPECT_GE(units::yards<int>{1}, units::feet<int>{3});
+    // 64 bit reps compare in the wide intermediate only where it holds them
+    using millimeters64 = units::millimeters<std::int64_t>;
+    using inches64 = units::inches<std::int64_t>;
+    static_assert(units::detail::wide_scales<millimeters64, inches64>::compare_fits ==
+                  (sizeof(units::detail::wide_int) > sizeof(std::int64_t)),
+                  "64 bit reps need a 128 bit intermediate");
+#if defined(__SIZEOF_INT128__)
+    constexpr std::int64_t half = (std::numeric_limits<std::int64_t>::max)() / 2;
+    static_assert(millimeters64{1} < inches64{half} &&
+                  inches64{-half} < millimeters64{1},
+                  "wide comparison must not overflow");
+#endif
+    EXPECT_LT(millimeters64{25}, inches64{1});
+
+    // Units a whole multiple of another convert to the finer one
+    using fine = std::common_type<units::feet<int>, units::inches<int> >::type;
+    static_assert(std::is_same<fine, units::inches<int> >::value,
+                  "common type of feet and inches must be inches");
+    EXPECT_EQ(units::inches<int>{15},
+              units::feet<int>{1} + units::inches<int>{3});
+
+    // Floating point reps compute in the common unit too
+    EXPECT_DOUBLE_EQ(26.4, units::units_cast<units::millimeters<double> >(
+                               units::inches<double>{1} +
+                               units::millimeters<double>{1}).amount());
+}
+
+TEST(UnitsTest, Chrono) {
+    using meters = units::meters<double>;
+    using kilometers = units::kilometers<double>;
+
+    // Durations convert to and from std::chrono without scaling
+    auto ms = units::from_chrono(std::chrono::milliseconds{1500});
+    static_assert(std::is_same<decltype(ms), units::milliseconds<
+                      std::chrono::milliseconds::rep> >::value,
+                  "from_chrono must keep the rep and period");
+    EXPECT_EQ(1500, ms.amount());
+    EXPECT_EQ(std::chrono::minutes{3},
+              units::to_chrono(units::minutes<int>{3}));
+
+    // Rates take their fraction from the std::chrono period
+    auto speed = meters{30.} / std::chrono::duration<double, std::milli>{1500.};
+    using speed_t = decltype(speed);
+    static_assert(std::is_same<speed_t::fraction,
+                               std::ratio_divide<meters::fraction,
+                                                 std::milli> >::value,
+                  "meters per millisecond must be folded at compile time");
+    static_assert(std::is_same<speed_t::units_tag,
+                               units::detail::dimension<1, 0, -1> >::value,
+                  "distance over time must be a speed");
+    using meters_per_second = units::units_divide<meters, units::seconds<double> >;
+    EXPECT_DOUBLE_EQ(20., units::units_cast<meters_per_second>(speed).amount());
+
+    // Rates multiplied by a std::chrono duration are back to a base unit
+    kilometers km = speed * std::chrono::hours{1};
+    EXPECT_DOUBLE_EQ(72., km.amount());
+    kilometers km2 = std::chrono::hours{1} * speed;
+    EXPECT_DOUBLE_EQ(72., km2.amount());
+}
+
+TEST(UnitsTest, UnitsPoint) {
+    using celsius = units::celsius_point<double>;
+    using fahrenheit = units::fahrenheit_point<double>;
+    using kelvin = units::kelvin_point<double>;
+
+    // Points convert with a scale and an offset
+    EXPECT_NEAR(212., units::units_point_cast<fahrenheit>(celsius{100.}).amount(),
+                1e-12);
+    EXPECT_NEAR(-40., units::units_point_cast<celsius>(fahrenheit{-40.}).amount(),
+                1e-12);
+    EXPECT_NEAR(273.15, units::units_point_cast<kelvin>(celsius{0.}).amount(),
+                1e-12);
+    static_assert(units::units_point_cast<units::celsius_point<int> >(
+                      units::kelvin_point<int>{373}).amount() == 99,
+                  "integral point casts truncate");
+
+    // Differences of points are units, and convert without the offset
+    units::celsius<double> rise = celsius{30.} - celsius{20.};
+    EXPECT_DOUBLE_EQ(10., rise.amount());
+    EXPECT_DOUBLE_EQ(18., units::units_cast<units::fahrenheit<double> >(
+                              rise).amount());
+
+    // Moving a point by a difference is a point
+    celsius warmer = celsius{20.} + units::celsius<double>{5.};
+    EXPECT_EQ(celsius{25.}, warmer);
+    EXPECT_EQ(celsius{25.}, units::celsius<double>{5.} + celsius{20.});
+    EXPECT_LT(celsius{15.}, celsius{20.} - units::fahrenheit<double>{5.});
+    warmer -= units::kelvin<double>{5.};
+    EXPECT_EQ(celsius{20.}, warmer);
+
+    // Any unit can be a point, such as an elevation above a datum
+    using datum = units::units_point<units::meters<double>, std::ratio<-100> >;
+    using sea_level = units::units_point<units::inches<double> >;
+    EXPECT_NEAR(-100., units::units_point_cast<sea_level>(datum{0.}).amount(),
+                1e-12);
+
+    // The bulk path matches the scalar path
+    std::vector<double> c(37);
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        c[i] = static_cast<double>(i) * 3. - 40.;
+    }
+    std::vector<double> f(c.size());
+    units::units_point_cast_n<fahrenheit, celsius>(c.data(), c.size(), f.data());
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        EXPECT_NEAR(units::units_point_cast<fahrenheit>(celsius{c[i]}).amount(),
+                    f[i], 1e-12);
+    }
+    // and rounds alike, to the bit, with whichever kernel the CPU runs
+    using fahrenheit_f = units::fahrenheit_point<float>;
+    using celsius_f = units::celsius_point<float>;
+    std::vector<float> random_c(1000);
+    std::uint32_t state = 12345;
+    for (float &v : random_c) {
+        state = state * 1664525u + 1013904223u;
+        v = static_cast<float>(state >> 8) / 65536.f - 128.f;
+    }
+    std::vector<float> random_f(random_c.size());
+    units::units_point_cast_n<fahrenheit_f, celsius_f>(
+        random_c.data(), random_c.size(), random_f.data());
+    for (std::size_t i = 0; i < random_c.size(); ++i) {
+        const float scalar =
+            units::units_point_cast<fahrenheit_f>(celsius_f{random_c[i]}).amount();
+        EXPECT_EQ(0, std::memcmp(&scalar, &random_f[i], sizeof(float)));
+    }
+    std::vector<float> cf(c.begin(), c.end());
+    units::units_point_cast_n<units::kelvin_point<float>,
+                              units::celsius_point<float> >(
+        cf.data(), cf.size(), cf.data());
+    EXPECT_FLOAT_EQ(233.15f, cf[0]);
+    EXPECT_FLOAT_EQ(341.15f, cf[36]);
+}
+
+TEST(UnitsTest, Serialize) {
+    using feet = units::feet<float>;
+    using inches = units::inches<float>;
+
+    // Identities depend on the tag and fraction, not the rep
+    static_assert(units::units_identity<feet>::value !=
+                      units::units_identity<inches>::value &&
+                  units::units_identity<feet>::value ==
+                      units::units_identity<units::feet<int> >::value &&
+                  units::units_identity<units::inches<int> >::value !=
+                      units::units_identity<units::ounces<int> >::value,
+                  "identities must tell units apart");
+
+    units::quantity_array<feet> ft(5);
+    for (std::size_t i = 0; i < ft.size(); ++i) {
+        ft[i] = feet{static_cast<float>(i) + 0.5f};
+    }
+    // Word storage keeps the payload aligned for the rep
+    const std::size_t size = units::serialized_size<feet>(ft.size());
+    std::vector<std::uint64_t> buffer((size + 7) / 8);
+    auto bytes = reinterpret_cast<unsigned char*>(buffer.data());
+    EXPECT_EQ(std::errc::value_too_large,
+              units::serialize(ft.span(), bytes, size - 1).ec);
+    auto written = units::serialize(ft.span(), bytes, size);
+    ASSERT_EQ(std::errc(), written.ec);
+    EXPECT_EQ(size, written.size);
+
+    // Matching units are viewed in place
+    auto view = units::view_units<feet>(bytes, size);
+    ASSERT_EQ(std::errc(), view.ec);
+    ASSERT_EQ(ft.size(), view.values.size());
+    EXPECT_EQ(static_cast<const void*>(bytes + units::units_header_size),
+              static_cast<const void*>(view.values.data()));
+    EXPECT_EQ(feet{4.5f}, view.values[4]);
+
+    // Other units of the dimension are rejected by a view and converted by
+    // a load
+    EXPECT_EQ(std::errc::wrong_protocol_type,
+              units::view_units<inches>(bytes, size).ec);
+    units::quantity_array<inches> in(ft.size());
+    auto loaded = units::load_units(bytes, size, in.span());
+    ASSERT_EQ(std::errc(), loaded.ec);
+    EXPECT_EQ(ft.size(), loaded.count);
+    EXPECT_FLOAT_EQ(54.f, in[4].amount());
+    units::quantity_array<inches> short_in(2);
+    EXPECT_EQ(std::errc::value_too_large,
+              units::load_units(bytes, size, short_in.span()).ec);
+    EXPECT_FLOAT_EQ(18.f, short_in[1].amount());
+
+    // Other dimensions and reps are rejected outright
+    units::quantity_array<units::grams<float> > g(ft.size());
+    EXPECT_EQ(std::errc::wrong_protocol_type,
+              units::load_units(bytes, size, g.span()).ec);
+    units::quantity_array<units::feet<double> > dft(ft.size());
+    EXPECT_EQ(std::errc::wrong_protocol_type,
+              units::load_units(bytes, size, dft.span()).ec);
+
+    // Truncated and corrupt buffers
+    EXPECT_EQ(std::errc::message_size,
+              units::view_units<feet>(bytes, size - 1).ec);
+    bytes[0] = 'X';
+    EXPECT_EQ(std::errc::invalid_argument,
+              units::view_units<feet>(bytes, size).ec);
+
+    // Integral reps convert exactly on load
+    units::quantity_array<units::yards<int> > yd(3, units::yards<int>{2});
+    std::vector<std::uint64_t> ybuffer(
+        (units::serialized_size<units::yards<int> >(yd.size()) + 7) / 8);
+    units::serialize(yd.span(), ybuffer.data(), ybuffer.size() * 8);
+    units::quantity_array<units::inches<int> > yin(yd.size());
+    units::load_units(ybuffer.data(), ybuffer.size() * 8, yin.span());
+    EXPECT_EQ(units::inches<int>{72}, yin[2]);
+
+    // Headers come from outside the program: a factor too large to scale by
+    // is rejected, and values that don't fit the rep are reported
+    auto set_num = [](void *b, std::int64_t num) {
+        units::units_header h;
+        std::memcpy(&h, b, sizeof h);
+        h.num = num;
+        std::memcpy(b, &h, sizeof h);
+    };
+    set_num(ybuffer.data(), std::int64_t(1) << 30);
+    EXPECT_EQ(std::errc::result_out_of_range,
+              units::load_units(ybuffer.data(), ybuffer.size() * 8,
+                                yin.span()).ec);
+    EXPECT_EQ((std::numeric_limits<int>::max)(), yin[0].amount());
+
+    units::quantity_array<units::yards<long long> > lyd(1, units::yards<long long>{1});
+    std::vector<std::uint64_t> lbuffer(
+        (units::serialized_size<units::yards<long long> >(lyd.size()) + 7) / 8);
+    units::serialize(lyd.span(), lbuffer.data(), lbuffer.size() * 8);
+    set_num(lbuffer.data(), (std::numeric_limits<std::int64_t>::max)() - 1);
+    units::quantity_array<units::millimeters<long long> > lmm(1);
+    EXPECT_EQ(std::errc::invalid_argument,
+              units::load_units(lbuffer.data(), lbuffer.size() * 8,
+                                lmm.span()).ec);
+}
+
+TEST(UnitsTest, RuntimeUnits) {
+    using distance_tag = units::detail::distance_tag;
+    using weight_tag = units::detail::weight_tag;
+
+    // Alternate spellings share the id of their fraction
+    static_assert(units::unit_id_count<distance_tag>() == 10 &&
+                  units::unit_id_count<weight_tag>() == 9,
+                  "every alias must have a runtime id");
+    constexpr auto ft = units::find_unit_id<distance_tag>("ft");
+    static_assert(ft == units::unit_id_of<units::feet<float> >(),
+                  "symbol and type ids must agree");
+    EXPECT_EQ(units::find_unit_id<distance_tag>("um"),
+              units::find_unit_id<distance_tag>("\u00b5m"));
+    EXPECT_FALSE(units::find_unit_id<distance_tag>("kg"));
+    EXPECT_STREQ("kg", units::unit_id_symbol(
+                           units::find_unit_id<weight_tag>("kg")));
+
+    // The factor matrix agrees with units_cast for every pair
+    const auto km = units::unit_id_of<units::kilometers<double> >();
+    const auto nmi = units::unit_id_of<units::nautical_miles<double> >();
+    EXPECT_DOUBLE_EQ(units::units_cast<units::nautical_miles<double> >(
+                         units::kilometers<double>{1.}).amount(),
+                     units::unit_id_factor<double>(km, nmi));
+
+    std::vector<float> values{1.f, 2.f, 3.f};
+    EXPECT_EQ(std::errc(),
+              units::units_cast_n(ft, units::find_unit_id<distance_tag>("in"),
+                                  values.data(), values.size(), values.data()));
+    EXPECT_FLOAT_EQ(36.f, values[2]);
+
+    std::vector<int> pounds{1, 2, 3};
+    std::vector<int> ounces(pounds.size());
+    EXPECT_EQ(std::errc(),
+              units::units_cast_n(units::find_unit_id<weight_tag>("lb"),
+                                  units::find_unit_id<weight_tag>("oz"),
+                                  pounds.data(), pounds.size(), ounces.data()));
+    EXPECT_EQ(48, ounces[2]);
+    units::units_cast_n(units::find_unit_id<weight_tag>("oz"),
+                        units::find_unit_id<weight_tag>("st"),
+                        ounces.data(), ounces.size(), ounces.data());
+    EXPECT_EQ(0, ounces[2]);
+
+    // Integral values that don't fit saturate, and are reported
+    std::vector<std::int16_t> heavy{1, 3000};
+    EXPECT_EQ(std::errc::result_out_of_range,
+              units::units_cast_n(units::find_unit_id<weight_tag>("lb"),
+                                  units::find_unit_id<weight_tag>("oz"),
+                                  heavy.data(), heavy.size(), heavy.data()));
+    EXPECT_EQ(16, heavy[0]);
+    EXPECT_EQ(32767, heavy[1]);
+    // as are factors too large to scale every value of the rep exactly
+    constexpr std::int64_t longest = (std::numeric_limits<std::int64_t>::max)();
+    std::vector<std::int64_t> far{1, longest};
+    const std::errc far_ec =
+        units::units_cast_n(km, units::find_unit_id<distance_tag>("um"),
+                            far.data(), far.size(), far.data());
+    if (sizeof(units::detail::wide_int) > sizeof(std::int64_t)) {
+        EXPECT_EQ(std::errc::result_out_of_range, far_ec);
+        EXPECT_EQ(1000000000, far[0]);
+        EXPECT_EQ(longest, far[1]);
+    } else {
+        EXPECT_EQ(std::errc::invalid_argument, far_ec);
+        EXPECT_EQ(1, far[0]);
+    }
+}
+
+TEST(UnitsTest, CompactReps) {
+    using half_mm = units::millimeters<units::float16>;
+    using brain_mm = units::millimeters<units::bfloat16>;
+    using centi_mm = units::millimeters<
+        units::fixed_point<std::int16_t, std::ratio<1, 100> > >;
+    using milli_in = units::inches<
+        units::fixed_point<std::int32_t, std::milli> >;
+    static_assert(sizeof(half_mm) == 2 && sizeof(brain_mm) == 2 &&
+                  sizeof(centi_mm) == 2 && sizeof(milli_in) == 4,
+                  "compact reps must keep their size");
+    static_assert(units::detail::is_rep_layout<half_mm>::value &&
+                  units::detail::is_rep_layout<centi_mm>::value,
+                  "compact units must fit in quantity arrays");
+
+    // Compact reps convert like floating point
+    static_assert(units::is_unit_convertible<half_mm,
+                      units::inches<float> >::value &&
+                  units::is_unit_convertible<units::inches<float>,
+                      centi_mm>::value,
+                  "compact reps must convert to and from float");
+    auto in = units::units_cast<units::inches<float> >(half_mm{50.8f});
+    EXPECT_NEAR(2.f, in.amount(), 0.001f);
+    EXPECT_EQ(units::float16(50.8f).bits, half_mm{in}.amount().bits);
+    EXPECT_FLOAT_EQ(25.4f, units::units_cast<centi_mm>(milli_in{1.}).amount());
+    EXPECT_FLOAT_EQ(0.5f, units::units_cast<centi_mm>(
+                              units::millimeters<double>{0.504}).amount());
+    EXPECT_EQ(32767, units::units_cast<centi_mm>(
+                         units::meters<float>{1.f}).amount().raw);
+
+    // Arithmetic happens in the compute type
+    half_mm h{1.5f};
+    h += half_mm{0.25f};
+    EXPECT_FLOAT_EQ(1.75f, h.amount());
+    EXPECT_LT(brain_mm{1.f}, brain_mm{1.5f});
+    EXPECT_FLOAT_EQ(3.f, (brain_mm{1.f} + brain_mm{2.f}).amount());
+
+    // Conversion corner cases
+    EXPECT_EQ(0x7c00, units::float16(1e6f).bits);
+    EXPECT_EQ(0x0001, units::float16(5.9604645e-8f).bits);
+    EXPECT_FLOAT_EQ(65504.f, units::float16(65504.f));
+    EXPECT_EQ(0x3f80, units::bfloat16(1.f).bits);
+    EXPECT_TRUE(std::isnan(float(units::bfloat16(
+        std::numeric_limits<float>::quiet_NaN()))));
+
+    // Bulk packing matches the scalar conversions, over the SIMD width
+    std::vector<float> values(37);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) * 1.37f - 20.f;
+    }
+    units::quantity_array<units::millimeters<float> > mm(values.size());
+    std::copy(values.begin(), values.end(), mm.span().raw_data());
+    units::quantity_array<half_mm> packed(mm.size());
+    EXPECT_EQ(mm.size(), units::pack_n(mm.span(), packed.span()));
+    units::quantity_array<brain_mm> bpacked(mm.size());
+    units::pack_n(mm.span(), bpacked.span());
+    units::quantity_array<centi_mm> fpacked(mm.size());
+    units::pack_n(mm.span(), fpacked.span());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(units::float16(values[i]).bits, packed[i].amount().bits);
+        EXPECT_EQ(units::bfloat16(values[i]).bits, bpacked[i].amount().bits);
+        EXPECT_NEAR(values[i], fpacked[i].amount(), 0.005f);
+    }
+    units::quantity_array<units::millimeters<float> > unpacked(mm.size());
+    units::unpack_n(packed.span(), unpacked.span());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_FLOAT_EQ(float(packed[i].amount()), unpacked[i].amount());
+    }
+    units::unpack_n(bpacked.span(), unpacked.span());
+    EXPECT_FLOAT_EQ(float(bpacked[36].amount()), unpacked[36].amount());
+
+    // Limits are the compact reps' own, so saturating casts clamp to them
+    EXPECT_FLOAT_EQ(65504.f, std::numeric_limits<units::float16>::max());
+    EXPECT_FLOAT_EQ(-65504.f, std::numeric_limits<units::float16>::lowest());
+    EXPECT_EQ(units::bfloat16(std::numeric_limits<float>::max()).bits - 1,
+              std::numeric_limits<units::bfloat16>::max().bits);
+    EXPECT_FLOAT_EQ(-327.68f, std::numeric_limits<centi_mm::rep>::lowest());
+    EXPECT_NEAR(50.8f, (units::units_cast<half_mm, units::cast_policy::saturating>(
+                           units::inches<float>{2}).amount()), 0.05f);
+    EXPECT_FLOAT_EQ(65504.f, (units::units_cast<half_mm, units::cast_policy::saturating>(
+                                 units::meters<float>{1000}).amount()));
+    EXPECT_FLOAT_EQ(327.67f, (units::units_cast<centi_mm, units::cast_policy::saturating>(
+                                 units::meters<float>{1}).amount()));
+    EXPECT_FLOAT_EQ(-327.68f, (units::units_cast<centi_mm, units::cast_policy::saturating>(
+                                  units::inches<float>{-50}).amount()));
+
+    // and reductions start from them
+    units::quantity_array<half_mm> hv(4, half_mm{3.f});
+    hv[2] = half_mm{5.f};
+    EXPECT_FLOAT_EQ(3.f, units::minimum(hv.span()).amount());
+    EXPECT_FLOAT_EQ(5.f, units::maximum(hv.span()).amount());
+    units::quantity_array<centi_mm> cv(3, centi_mm{-2.5f});
+    cv[1] = centi_mm{-1.25f};
+    EXPECT_FLOAT_EQ(-2.5f, units::minimum(cv.span()).amount());
+    EXPECT_FLOAT_EQ(-1.25f, units::maximum(cv.span()).amount());
+}
+
+namespace {
+
+// Every alias must cost nothing over its rep
+template <template <typename> class alias, typename rep>
+constexpr bool has_rep_layout() {
+    using unit = alias<rep>;
+    return std::is_trivially_copyable<unit>::value &&
+        std::is_standard_layout<unit>::value &&
+        sizeof(unit) == sizeof(rep) && alignof(unit) == alignof(rep);
+}
+
+template <template <typename> class alias>
+constexpr bool has_rep_layouts() {
+    return has_rep_layout<alias, float>() && has_rep_layout<alias, double>() &&
+        has_rep_layout<alias, std::int32_t>() &&
+        has_rep_layout<alias, std::int64_t>();
+}
+
+static_assert(has_rep_layouts<units::inches>() &&
+              has_rep_layouts<units::feet>() &&
+              has_rep_layouts<units::yards>() &&
+              has_rep_layouts<units::miles>() &&
+              has_rep_layouts<units::nautical_miles>() &&
+              has_rep_layouts<units::meters>() &&
+              has_rep_layouts<units::micrometers>() &&
+              has_rep_layouts<units::millimeters>() &&
+              has_rep_layouts<units::centimeters>() &&
+              has_rep_layouts<units::kilometers>(),
+              "distance aliases must be laid out as their rep");
+
+static_assert(has_rep_layouts<units::ounces>() &&
+              has_rep_layouts<units::pounds>() &&
+              has_rep_layouts<units::stones>() &&
+              has_rep_layouts<units::short_tons>() &&
+              has_rep_layouts<units::long_tons>() &&
+              has_rep_layouts<units::grams>() &&
+              has_rep_layouts<units::micrograms>() &&
+              has_rep_layouts<units::kilograms>() &&
+              has_rep_layouts<units::metric_tons>(),
+              "weight aliases must be laid out as their rep");
+
+static_assert(has_rep_layouts<units::seconds>() &&
+              has_rep_layouts<units::nanoseconds>() &&
+              has_rep_layouts<units::microseconds>() &&
+              has_rep_layouts<units::milliseconds>() &&
+              has_rep_layouts<units::minutes>() &&
+              has_rep_layouts<units::hours>(),
+              "duration aliases must be laid out as their rep");
+
+// The arithmetic, comparison and cast surface folds at compile time
+constexpr units::inches<double> compound() {
+    units::inches<double> i{1.};
+    i += units::feet<double>{1.};
+    i -= units::inches<double>{3.};
+    i += 2.;
+    i -= 1.;
+    i *= 4.;
+    i /= 2.;
+    return -(+i);
+}
+
+static_assert(compound().amount() == -22., "compound operators are constexpr");
+static_assert(units::inches<int>{2} < units::inches<int>{3} &&
+              units::inches<int>{3} <= units::inches<int>{3} &&
+              units::inches<int>{4} > units::inches<int>{3} &&
+              units::inches<int>{3} >= units::inches<int>{3} &&
+              units::inches<int>{3} == units::inches<int>{3} &&
+              units::inches<int>{2} != units::inches<int>{3},
+              "comparisons are constexpr");
+static_assert((units::inches<int>{2} + units::inches<int>{3} -
+               units::inches<int>{1}).amount() == 4 &&
+              (units::inches<int>{2} * 3 / 2 + 1 - 2).amount() == 2 &&
+              units::inches<int>{24} / units::feet<int>{1} == 2,
+              "arithmetic is constexpr");
+static_assert(units::units_cast<units::millimeters<int> >(
+                  units::meters<int>{3}).amount() == 3000,
+              "units_cast is constexpr");
+static_assert(noexcept(units::inches<float>{} += units::feet<float>{}) &&
+              noexcept(units::inches<float>{} < units::inches<float>{}) &&
+              noexcept(units::units_cast<units::feet<float> >(
+                  units::inches<float>{})),
+              "hot operations are noexcept");
+
+} // namespace
+
+namespace {
+
+// Flattened alias fractions must match the chains they were derived from
+template <template <typename> class alias, typename fraction>
+constexpr bool has_fraction() {
+    return std::ratio_equal<typename alias<int>::fraction, fraction>::value;
+}
+
+using in_per_m = std::ratio<10000, 254>;
+using oz_per_g = std::ratio<10000, 283495>;
+
+static_assert(has_fraction<units::feet, std::ratio<12> >() &&
+              has_fraction<units::yards, std::ratio<3 * 12> >() &&
+              has_fraction<units::miles, std::ratio<1760 * 3 * 12> >() &&
+              has_fraction<units::nautical_miles, std::ratio<729134, 10> >() &&
+              has_fraction<units::meters, in_per_m>() &&
+              has_fraction<units::micrometers,
+                           std::ratio_multiply<std::micro, in_per_m> >() &&
+              has_fraction<units::millimeters,
+                           std::ratio_multiply<std::milli, in_per_m> >() &&
+              has_fraction<units::centimeters,
+                           std::ratio_multiply<std::centi, in_per_m> >() &&
+              has_fraction<units::kilometers,
+                           std::ratio_multiply<std::kilo, in_per_m> >(),
+              "distance fractions must match their derivations");
+
+static_assert(has_fraction<units::pounds, std::ratio<16> >() &&
+              has_fraction<units::stones, std::ratio<14 * 16> >() &&
+              has_fraction<units::short_tons, std::ratio<2000 * 16> >() &&
+              has_fraction<units::long_tons, std::ratio<2240 * 16> >() &&
+              has_fraction<units::grams, oz_per_g>() &&
+              has_fraction<units::micrograms,
+                           std::ratio_multiply<std::micro, oz_per_g> >() &&
+              has_fraction<units::kilograms,
+                           std::ratio_multiply<std::kilo, oz_per_g> >() &&
+              has_fraction<units::metric_tons,
+                           std::ratio_multiply<std::mega, oz_per_g> >(),
+              "weight fractions must match their derivations");
+
+static_assert(has_fraction<units::hours, std::ratio<60 * 60> >(),
+              "duration fractions must match their derivations");
+
+} // namespace
+
+TEST(UnitsTest, AtomicUnits) {
+    using mm = units::millimeters<std::int64_t>;
+    using m = units::meters<double>;
+    static_assert(units::atomic_units<mm>::is_always_lock_free &&
+                  units::atomic_units<m>::is_always_lock_free,
+                  "arithmetic reps must be lock-free");
+
+    // Any convertible unit is scaled before the atomic operation
+    units::atomic_units<mm> a{mm{5}};
+    EXPECT_EQ(5, a.fetch_add(units::meters<std::int64_t>{2}).amount());
+    EXPECT_EQ(2005, a.load().amount());
+    EXPECT_EQ(1505, (a -= mm{500}).amount());
+    a.store(units::centimeters<std::int64_t>{3});
+    EXPECT_EQ(30, a.exchange(mm{1}).amount());
+    mm expected{2};
+    EXPECT_FALSE(a.compare_exchange_strong(expected, mm{7}));
+    EXPECT_EQ(1, expected.amount());
+    EXPECT_TRUE(a.compare_exchange_strong(expected, mm{7}));
+    EXPECT_EQ(7, mm(a).amount());
+
+    units::atomic_units<m> d;
+    d += units::millimeters<double>{250.};
+    d.fetch_sub(units::centimeters<double>{5.});
+    EXPECT_DOUBLE_EQ(0.2, d.load().amount());
+
+    // Concurrent adds from many threads lose nothing
+    constexpr int threads = 8, adds = 10000;
+    units::atomic_units<m> total;
+    units::sharded_units<mm> sharded(4);
+    units::sharded_units<m> sharded_float;
+    EXPECT_EQ(4u, sharded.shard_count());
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < adds; ++i) {
+                total += units::millimeters<double>{1.};
+                sharded += units::meters<std::int64_t>{1};
+                sharded -= mm{1};
+                sharded_float.add(units::millimeters<double>{1.});
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    EXPECT_NEAR(80., total.load().amount(), 1e-9);
+    EXPECT_EQ(999 * threads * adds, sharded.load().amount());
+    EXPECT_NEAR(80., sharded_float.load().amount(), 1e-9);
+    EXPECT_EQ(999 * threads * adds, sharded.reset().amount());
+    EXPECT_EQ(0, sharded.load().amount());
+}
+
+TEST(UnitsTest, ConversionInstrumentation) {
+    using mm = units::millimeters<float>;
+    using in = units::inches<float>;
+    units::reset_conversion_counts();
+
+    mm total{0.f};
+    unsigned line = 0;
+    for (int i = 0; i < 10; ++i) {
+        line = __LINE__ + 1;
+        mm step = in{1.f};
+        total += step;
+        total += in{1.f};
+    }
+    EXPECT_FLOAT_EQ(508.f, total.amount());
+
+    // Constant evaluation is never counted
+    constexpr mm folded = units::inches<int>{1};
+    static_assert(folded.amount() == 25.4f, "conversion must stay constexpr");
+
+    // Conversions made by the library count where they are asked for, not
+    // inside its headers
+    using narrow = units::bounded_units<units::inches<int>, std::ratio<0>,
+                                        std::ratio<10> >;
+    using wide = units::bounded_units<mm, std::ratio<-1>, std::ratio<1000> >;
+    const unsigned bounded_line = __LINE__ + 1;
+    const wide widened = narrow::constant<std::ratio<2> >();
+    EXPECT_FLOAT_EQ(50.8f, widened.amount());
+
+    const auto report = units::conversion_report();
+#if UNITS_INSTRUMENT_CONVERSIONS
+    ASSERT_EQ(3u, report.size());
+    const std::string site = __FILE__ ":" + std::to_string(line);
+    const std::string bounded_site = __FILE__ ":" + std::to_string(bounded_line);
+    for (const auto &c : report) {
+        EXPECT_EQ(c.site == bounded_site ? 1u : 10u, c.count);
+        EXPECT_NE(std::string::npos, c.from.find("std::ratio<1>"));
+        EXPECT_NE(std::string::npos, c.to.find("std::ratio<5, 127>"));
+        EXPECT_EQ(std::string::npos, c.site.find("include/"));
+    }
+    EXPECT_EQ(1, std::count_if(report.begin(), report.end(),
+                               [&](const units::conversion_count &c) {
+                                   return c.site == site;
+                               }));
+    EXPECT_EQ(1, std::count_if(report.begin(), report.end(),
+                               [&](const units::conversion_count &c) {
+                                   return c.site == bounded_site;
+                               }));
+    units::reset_conversion_counts();
+    EXPECT_TRUE(units::conversion_report().empty());
+#else
+    EXPECT_TRUE(report.empty());
+    EXPECT_EQ(0u, units::conversions_dropped());
+    static_cast<void>(line);
+    static_cast<void>(bounded_line);
+#endif
+}
+
+TEST(UnitsTest, Expressions) {
+    using in = units::inches<float>;
+    using mm = units::millimeters<float>;
+    using ft = units::feet<float>;
+    const std::size_t n = 37;
+    units::quantity_array<in> a(n);
+    units::quantity_array<mm> b(n);
+    units::quantity_array<ft> c(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = in{static_cast<float>(i)};
+        b[i] = mm{static_cast<float>(i) * 3.f};
+        c[i] = ft{0.5f};
+    }
+
+    // One pass, converted into the unit asked for
+    auto total = units::evaluate<mm>(a + b * 2.f - c);
+    ASSERT_EQ(n, total.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        const mm expected = a[i] + mm{b[i].amount() * 2.f} - c[i];
+        EXPECT_NEAR(expected.amount(), total[i].amount(), 1e-3f);
+    }
+
+    // The natural unit of a sum is the common unit, as for units
+    using sum_unit = units::expr_unit<decltype(a + b)>;
+    static_assert(std::is_same<sum_unit::fraction,
+                               std::common_type<in, mm>::type::fraction>::value,
+                  "sums evaluate in the common unit");
+    auto sum = units::evaluate(a + b);
+    EXPECT_NEAR(25.4f * 10.f + 30.f,
+                units::units_cast<mm>(sum[10]).amount(), 1e-3f);
+
+    // Constants, scalars and negation
+    units::quantity_array<in> shifted(n);
+    EXPECT_EQ(n, units::evaluate(-(a / 2.f) + ft{1.f}, shifted.span()));
+    EXPECT_FLOAT_EQ(12.f - 5.f, shifted[10].amount());
+
+    // Products and quotients are composite units
+    units::quantity_array<units::seconds<double> > t(n, units::seconds<double>{2.});
+    units::quantity_array<units::meters<double> > d(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        d[i] = units::meters<double>{static_cast<double>(i)};
+    }
+    using velocity = units::units_divide<units::meters<double>,
+                                         units::seconds<double> >;
+    auto v = units::evaluate<velocity>(d / t);
+    EXPECT_DOUBLE_EQ(5., v[10].amount());
+    auto v_mm = units::evaluate<units::units_divide<
+        units::millimeters<double>, units::seconds<double> > >(d / t);
+    EXPECT_NEAR(5000., v_mm[10].amount(), 1e-9);
+
+    // In place, and over the common length of mismatched ranges
+    EXPECT_EQ(n, units::evaluate(a + a, a.span()));
+    EXPECT_FLOAT_EQ(20.f, a[10].amount());
+    units::quantity_span<const mm> head(b.data(), 5);
+    auto short_sum = units::evaluate(head + c);
+    EXPECT_EQ(5u, short_sum.size());
+
+    // A range overlapping out at an offset reads what was just written
+    for (std::size_t shift : {1, 3, 8}) {
+        units::quantity_array<in> chain(64 + shift, in{1.f});
+        units::quantity_span<in> from(chain.data(), 64);
+        units::quantity_span<in> to(chain.data() + shift, 64);
+        EXPECT_EQ(64u, units::evaluate(from * 2.f + from, to));
+        EXPECT_FLOAT_EQ(3.f, chain[shift].amount());
+        EXPECT_FLOAT_EQ(243.f, chain[5 * shift].amount());
+    }
+
+    // Integral reps compute in double and round on the way out
+    units::quantity_array<units::millimeters<int> > mm_int(3, units::millimeters<int>{10});
+    units::quantity_array<units::inches<int> > in_int(3);
+    units::evaluate(mm_int * 127 + units::inches<int>{1}, in_int.span());
+    EXPECT_EQ(51, in_int[0].amount());
+
+    // Temporary arrays would dangle
+    static_assert(!units::detail::is_expr_operand<units::quantity_array<mm> >::value &&
+                  units::detail::is_expr_operand<units::quantity_array<mm>&>::value,
+                  "temporary arrays must be refused");
+}
+
+TEST(UnitsTest, CompareHashSort) {
+    // Integral comparisons across fractions are exact over the whole range,
+    // given a 128 bit intermediate for 64 bit reps
+    constexpr auto big = (std::numeric_limits<std::int64_t>::max)();
+    using in64 = units::inches<std::int64_t>;
+    using mm64 = units::millimeters<std::int64_t>;
+#if defined(__SIZEOF_INT128__)
+    EXPECT_TRUE(in64{big} > mm64{big});
+    EXPECT_TRUE(in64{-big} < mm64{1});
+#endif
+    EXPECT_TRUE(units::feet<std::int64_t>{big / 12} == in64{big / 12 * 12});
+    EXPECT_TRUE(in64{5} == mm64{127});
+    EXPECT_TRUE(in64{5} < mm64{128});
+    static_assert(units::inches<int>{1} != units::millimeters<int>{25},
+                  "mixed comparison must stay constexpr");
+
+    // Equal quantities hash equally in any unit
+    std::hash<units::feet<int> > hash_ft;
+    std::hash<units::inches<int> > hash_in;
+    std::hash<units::millimeters<int> > hash_mm;
+    std::hash<units::centimeters<long long> > hash_cm;
+    EXPECT_EQ(hash_ft(units::feet<int>{1}), hash_in(units::inches<int>{12}));
+    EXPECT_EQ(hash_mm(units::millimeters<int>{10}),
+              hash_cm(units::centimeters<long long>{1}));
+    EXPECT_NE(hash_in(units::inches<int>{1}), hash_in(units::inches<int>{2}));
+    EXPECT_EQ(std::hash<units::feet<float> >()(units::feet<float>{1.5f}),
+              std::hash<units::inches<double> >()(units::inches<double>{18.}));
+    EXPECT_EQ(std::hash<units::inches<double> >()(units::inches<double>{0.}),
+              std::hash<units::inches<double> >()(units::inches<double>{-0.}));
+    std::unordered_set<units::inches<int> > seen;
+    for (int i = 0; i < 100; ++i) {
+        seen.insert(units::inches<int>{i % 10});
+    }
+    EXPECT_EQ(10u, seen.size());
+
+    // Radix sort orders as the amounts, above and below the std::sort cutoff
+    std::mt19937 gen(7);
+    for (std::size_t n : {std::size_t(100), std::size_t(5000)}) {
+        std::uniform_real_distribution<float> real(-1e6f, 1e6f);
+        units::quantity_array<units::meters<float> > f(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            f[i] = units::meters<float>{real(gen)};
+        }
+        f[0] = units::meters<float>{std::numeric_limits<float>::infinity()};
+        f[1] = units::meters<float>{-std::numeric_limits<float>::infinity()};
+        f[2] = units::meters<float>{0.f};
+        std::vector<float> expected(f.raw_data(), f.raw_data() + n);
+        std::sort(expected.begin(), expected.end());
+        units::radix_sort(f.span());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), f.raw_data()));
+
+        std::uniform_int_distribution<std::int64_t> whole(-big, big);
+        units::quantity_array<mm64> ints(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ints[i] = mm64{whole(gen)};
+        }
+        units::radix_sort(ints.span());
+        EXPECT_TRUE(std::is_sorted(ints.begin(), ints.end()));
+    }
+
+    // Digits every key shares are skipped
+    units::quantity_array<units::grams<std::uint16_t> > small(
+        3000, units::grams<std::uint16_t>{7});
+    small[1234] = units::grams<std::uint16_t>{3};
+    units::radix_sort(small.span());
+    EXPECT_EQ(3, small[0].amount());
+    EXPECT_EQ(7, small[2999].amount());
+}
+
+TEST(UnitsTest, LookupTables) {
+    using mm = units::millimeters<float>;
+    using kg = units::kilograms<float>;
+
+    // Calibration at 0, 10, 20, 30 mm
+    const units::uniform_table<mm, kg> uniform(
+        mm{0.f}, units::centimeters<float>{1.f},
+        {kg{0.f}, kg{5.f}, kg{20.f}, kg{30.f}});
+    EXPECT_EQ(4u, uniform.size());
+    EXPECT_FLOAT_EQ(10.f, uniform.step().amount());
+    EXPECT_FLOAT_EQ(2.5f, uniform(mm{5.f}).amount());
+    EXPECT_FLOAT_EQ(12.5f, uniform(units::centimeters<float>{1.5f}).amount());
+    EXPECT_FLOAT_EQ(20.f, uniform(units::millimeters<int>{20}).amount());
+    // Clamped to the ends, NaN to the first value
+    EXPECT_FLOAT_EQ(0.f, uniform(mm{-100.f}).amount());
+    EXPECT_FLOAT_EQ(30.f, uniform(mm{1000.f}).amount());
+    EXPECT_FLOAT_EQ(0.f, uniform(mm{std::numeric_limits<float>::quiet_NaN()}).amount());
+
+    const units::piecewise_table<mm, kg> piecewise(
+        std::vector<units::centimeters<float> >{
+            units::centimeters<float>{0.f}, units::centimeters<float>{1.f},
+            units::centimeters<float>{1.f}, units::centimeters<float>{4.f}},
+        {kg{0.f}, kg{10.f}, kg{40.f}, kg{70.f}});
+    EXPECT_EQ(4u, piecewise.size());
+    EXPECT_FLOAT_EQ(10.f, piecewise.key(1).amount());
+    EXPECT_FLOAT_EQ(5.f, piecewise(mm{5.f}).amount());
+    // A repeated breakpoint is a step to the later value
+    EXPECT_FLOAT_EQ(40.f, piecewise(mm{10.f}).amount());
+    EXPECT_FLOAT_EQ(50.f, piecewise(mm{20.f}).amount());
+    EXPECT_FLOAT_EQ(0.f, piecewise(mm{-1.f}).amount());
+    EXPECT_FLOAT_EQ(70.f, piecewise(mm{41.f}).amount());
+
+    // Degenerate tables
+    EXPECT_FLOAT_EQ(0.f, (units::uniform_table<mm, kg>()(mm{3.f})).amount());
+    EXPECT_FLOAT_EQ(0.f, (units::piecewise_table<mm, kg>()(mm{3.f})).amount());
+    EXPECT_FLOAT_EQ(7.f, (units::uniform_table<mm, kg>(
+        mm{1.f}, mm{1.f}, {kg{7.f}})(mm{3.f})).amount());
+    EXPECT_FLOAT_EQ(7.f, (units::piecewise_table<mm, kg>(
+        std::vector<mm>{mm{1.f}}, {kg{7.f}})(mm{-3.f})).amount());
+
+    // Batches of every length around the vector width match single lookups,
+    // with keys in another unit of the axis
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> real(-0.5f, 4.5f);
+    for (std::size_t n : {std::size_t(1), std::size_t(7), std::size_t(8),
+                          std::size_t(9), std::size_t(61)}) {
+        units::quantity_array<units::centimeters<float> > keys(n);
+        for (auto &k : keys) {
+            k = units::centimeters<float>{real(gen)};
+        }
+        units::quantity_array<kg> a(n), b(n);
+        EXPECT_EQ(n, uniform.evaluate(keys.span(), a.span()));
+        EXPECT_EQ(n, piecewise.evaluate(keys.span(), b.span()));
+        for (std::size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(uniform(keys[i]).amount(), a[i].amount(), 1e-4f);
+            EXPECT_NEAR(piecewise(keys[i]).amount(), b[i].amount(), 1e-4f);
+        }
+    }
+
+    // Larger tables, in the table's own key unit
+    std::vector<kg> values;
+    std::vector<mm> breaks;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(kg{static_cast<float>(i % 17)});
+        breaks.push_back(mm{static_cast<float>(i * i)});
+    }
+    const units::uniform_table<mm, kg> wide(mm{-50.f}, mm{0.25f}, values);
+    const units::piecewise_table<mm, kg> uneven(breaks, values);
+    std::uniform_real_distribution<float> range(-100.f, 1.1e6f);
+    std::vector<float> in(333), out(333);
+    for (auto &x : in) {
+        x = range(gen);
+    }
+    in[5] = std::numeric_limits<float>::quiet_NaN();
+    wide.evaluate_n(in.data(), in.size(), out.data());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        EXPECT_NEAR(wide(mm{in[i]}).amount(), out[i], 1e-3f);
+    }
+    uneven.evaluate_n(in.data(), in.size(), out.data());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        EXPECT_NEAR(uneven(mm{in[i]}).amount(), out[i], 1e-3f);
+    }
+}
+
+TEST(UnitsTest, BoundedUnits) {
+    using reach = units::bounded_units<units::millimeters<int>,
+                                       std::ratio<0>, std::ratio<2000> >;
+    using load = units::bounded_units<units::kilograms<float>,
+                                      std::ratio<0>, std::ratio<500> >;
+
+    // Untrusted data is checked once
+    auto r = units::make_bounded<reach>(units::centimeters<int>{150});
+    EXPECT_EQ(std::errc(), r.ec);
+    EXPECT_EQ(1500, r.value.amount());
+    auto over = units::make_bounded<reach>(units::meters<int>{3});
+    EXPECT_EQ(std::errc::result_out_of_range, over.ec);
+    EXPECT_EQ(2000, over.value.amount());
+    auto nan = units::make_bounded<load>(
+        units::grams<float>{std::numeric_limits<float>::quiet_NaN()});
+    EXPECT_EQ(std::errc::invalid_argument, nan.ec);
+    EXPECT_EQ(0.f, nan.value.amount());
+    EXPECT_FLOAT_EQ(0.f, load::clamp(units::grams<float>{-3.f}).amount());
+    EXPECT_TRUE(load::contains(units::grams<float>{250.f}));
+    EXPECT_FALSE(reach::contains(units::millimeters<long long>{-1}));
+
+    // Integral reps round declared bounds inward
+    using halves = units::bounded_units<units::grams<int>,
+                                        std::ratio<1, 2>, std::ratio<7, 2> >;
+    static_assert(std::is_same<halves::lower, std::ratio<1> >::value &&
+                  std::is_same<halves::upper, std::ratio<3> >::value,
+                  "integral bounds round inward");
+    EXPECT_EQ(1, halves().amount());
+    EXPECT_EQ(0, reach().amount());
+    constexpr reach twelve = reach::constant<std::ratio<12> >();
+    static_assert(twelve.amount() == 12, "constants are checked at compile time");
+
+    // Bounds propagate through arithmetic
+    const reach a = reach::constant<std::ratio<1500> >();
+    const reach b = reach::constant<std::ratio<200> >();
+    auto sum = a + b;
+    static_assert(std::is_same<decltype(sum)::lower, std::ratio<0> >::value &&
+                  std::is_same<decltype(sum)::upper, std::ratio<4000> >::value,
+                  "sums add bounds");
+    EXPECT_EQ(1700, sum.amount());
+    auto difference = b - a;
+    static_assert(std::is_same<decltype(difference)::lower, std::ratio<-2000> >::value &&
+                  std::is_same<decltype(difference)::upper, std::ratio<2000> >::value,
+                  "differences subtract opposite bounds");
+    EXPECT_EQ(-1300, difference.amount());
+    // Operands whose scaled bounds exceed the common rep still sum exactly
+    using span = units::bounded_units<units::inches<int>,
+                                      std::ratio<0>, std::ratio<20000000> >;
+    using offset = units::bounded_units<units::millimeters<int>,
+                                        std::ratio<-200000000>, std::ratio<-100000000> >;
+    auto far = span::clamp(units::inches<int>{20000000}) +
+               offset::clamp(units::millimeters<int>{-100000000});
+    EXPECT_EQ(2040000000, far.amount());
+    // with or without a 128 bit intermediate
+    constexpr std::int64_t longest = (std::numeric_limits<std::int64_t>::max)() >> 8;
+    using long_span = units::bounded_units<units::inches<std::int64_t>,
+                                           std::ratio<0>, std::ratio<longest> >;
+    using long_offset = units::bounded_units<units::millimeters<std::int64_t>,
+                                             std::ratio<0>, std::ratio<1000> >;
+    EXPECT_EQ(longest * 127 + 5000,
+              (long_span::max() + long_offset::max()).amount());
+    auto negated = -difference;
+    EXPECT_EQ(1300, negated.amount());
+    auto area = a * b;
+    static_assert(std::is_same<decltype(area)::upper, std::ratio<4000000> >::value,
+                  "products multiply bounds");
+    EXPECT_EQ(300000, area.amount());
+
+    using lever = units::bounded_units<units::meters<float>,
+                                       std::ratio<1, 2>, std::ratio<2> >;
+    auto per_meter = load::constant<std::ratio<100> >() / lever::max();
+    static_assert(std::is_same<decltype(per_meter)::lower, std::ratio<0> >::value &&
+                  std::is_same<decltype(per_meter)::upper, std::ratio<1000> >::value,
+                  "quotients divide bounds");
+    EXPECT_FLOAT_EQ(50.f, per_meter.amount());
+    EXPECT_EQ(7, a / b);
+
+    // and widen on conversion between fractions
+    auto cm = units::units_cast<units::centimeters<int> >(a);
+    static_assert(std::is_same<decltype(cm)::upper, std::ratio<200> >::value,
+                  "conversions scale bounds");
+    EXPECT_EQ(150, cm.amount());
+    auto in = units::units_cast<units::inches<int> >(a);
+    static_assert(std::is_same<decltype(in)::lower, std::ratio<0> >::value &&
+                  std::is_same<decltype(in)::upper, std::ratio<79> >::value,
+                  "integral conversions round bounds outward");
+    EXPECT_EQ(59, in.amount());
+    auto lb = units::units_cast<units::pounds<float> >(load::max());
+    EXPECT_TRUE(lb <= decltype(lb)::max());
+    EXPECT_NEAR(1102.31f, lb.amount(), 0.01f);
+
+    // Narrower bounds convert to wider ones implicitly, and to plain units
+    units::bounded_units<units::meters<float>, std::ratio<-5>, std::ratio<5> > wide = a;
+    EXPECT_FLOAT_EQ(1.5f, wide.amount());
+    static_assert(!std::is_convertible<decltype(wide), reach>::value,
+                  "wider bounds must be checked");
+    units::millimeters<int> plain = a;
+    EXPECT_EQ(1500, plain.amount());
+
+    EXPECT_TRUE(a > b);
+    EXPECT_TRUE(a == units::meters<int>{0} + units::millimeters<int>{1500});
+    EXPECT_TRUE(units::centimeters<int>{20} == b);
+    EXPECT_TRUE(wide != b);
+}
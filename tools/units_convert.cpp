@@ -0,0 +1,495 @@
+// units_convert: convert one column of a large binary or CSV file between
+// units, e.g.
+//
+//     units_convert --format csv --column 3 nmi km telemetry.csv > out.csv
+//     units_convert --format f32 --columns 4 --column 0 mm in samples.bin
+//
+// The input is memory mapped, or read from pipes, and processed in bounded
+// windows. Each window is split into chunks converted across a pool of
+// threads, then written out in order, so memory use does not grow with the
+// size of the input.
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// STL
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+// Units
+#include "distance.h"
+#include "duration.h"
+#include "units_cast_n.h"
+#include "units_runtime.h"
+#include "units_symbol.h"
+#include "weight.h"
+
+namespace {
+
+const char *usage =
+    "usage: units_convert [options] FROM TO [INPUT]\n"
+    "\n"
+    "Convert a column of INPUT (or stdin) from unit symbol FROM to TO.\n"
+    "\n"
+    "  --format csv|f32|f64  input format (default csv)\n"
+    "  --column K            zero based column to convert (default 0)\n"
+    "  --columns N           values per record of binary input (default 1)\n"
+    "  --delimiter C         CSV delimiter (default ,)\n"
+    "  --header              pass the first CSV line through unchanged\n"
+    "  --threads T           worker threads (default: hardware threads)\n"
+    "  --output FILE         write to FILE instead of stdout\n";
+
+// Factor from one unit symbol to another of the same dimension
+template <typename units_tag>
+bool find_factor(std::string_view from, std::string_view to,
+                 long double &factor) {
+    const auto f = units::find_unit_id<units_tag>(from);
+    const auto t = units::find_unit_id<units_tag>(to);
+    if (!f || !t) {
+        return false;
+    }
+    factor = units::unit_id_factor<long double>(f, t);
+    return true;
+}
+
+bool find_factor(std::string_view from, std::string_view to,
+                 long double &factor) {
+    return find_factor<units::detail::distance_tag>(from, to, factor) ||
+        find_factor<units::detail::weight_tag>(from, to, factor) ||
+        find_factor<units::detail::duration_tag>(from, to, factor);
+}
+
+// Bytes of input converted per window, split across the threads
+constexpr std::size_t window_bytes = std::size_t(64) << 20;
+
+// Input read one window at a time. Regular files are memory mapped, and
+// other input (pipes) is read into a buffer of one window. Each window holds
+// the bytes the last one left over, such as a partial line, followed by up
+// to window_bytes more, so memory use does not grow with the input.
+class input_file {
+public:
+    explicit input_file(const char *path)
+        : fd_(path ? ::open(path, O_RDONLY) : STDIN_FILENO), close_(path) {
+        if (fd_ < 0) {
+            std::perror(path);
+            std::exit(1);
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            const std::size_t size = static_cast<std::size_t>(st.st_size);
+            void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p != MAP_FAILED) {
+                ::madvise(p, size, MADV_SEQUENTIAL);
+                map_ = static_cast<const char*>(p);
+                map_size_ = size;
+            }
+        }
+    }
+
+    input_file(const input_file&) = delete;
+    input_file& operator=(const input_file&) = delete;
+
+    ~input_file() {
+        if (map_) {
+            ::munmap(const_cast<char*>(map_), map_size_);
+        }
+        if (close_) {
+            ::close(fd_);
+        }
+    }
+
+    // Move to the next window, starting with the last keep bytes of this
+    // one. Returns false once the window would be empty.
+    bool next(std::size_t keep) {
+        offset_ += size_ - keep;
+        if (map_) {
+            const std::size_t end = std::min(map_size_,
+                                             offset_ + keep + window_bytes);
+            data_ = map_ + offset_;
+            size_ = end - offset_;
+            end_ = end == map_size_;
+            release(offset_);
+        } else {
+            if (keep > 0) {
+                std::memmove(buffer_.data(), data_ + size_ - keep, keep);
+            }
+            buffer_.resize(keep + window_bytes);
+            size_ = keep;
+            while (!end_ && size_ < buffer_.size()) {
+                const ssize_t n = ::read(fd_, buffer_.data() + size_,
+                                         buffer_.size() - size_);
+                if (n <= 0) {
+                    end_ = true;
+                } else {
+                    size_ += static_cast<std::size_t>(n);
+                }
+            }
+            data_ = buffer_.data();
+        }
+        return size_ > 0;
+    }
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    // Offset of the window in the input
+    std::size_t offset() const { return offset_; }
+    // Whether the window runs to the end of the input
+    bool at_end() const { return end_; }
+
+private:
+    // Release mapped pages before offset, keeping resident memory bounded
+    void release(std::size_t offset) const {
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t end = offset / page * page;
+        if (end > 0) {
+            ::madvise(const_cast<char*>(map_), end, MADV_DONTNEED);
+        }
+    }
+
+    int fd_;
+    bool close_;
+    const char *map_ = nullptr;
+    std::size_t map_size_ = 0;
+    std::vector<char> buffer_;
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t offset_ = 0;
+    bool end_ = false;
+};
+
+// Fixed set of workers running batches of indexed tasks
+class thread_pool {
+public:
+    explicit thread_pool(unsigned threads) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto &w : workers_) {
+            w.join();
+        }
+    }
+
+    // Run task(0) .. task(n - 1) and wait for all of them
+    void run(std::size_t n, const std::function<void(std::size_t)> &task) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_ = &task;
+        next_ = 0;
+        count_ = n;
+        pending_ = n;
+        wake_.notify_all();
+        done_.wait(lock, [this] { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return stop_ || next_ < count_; });
+            if (stop_) {
+                return;
+            }
+            const std::size_t i = next_++;
+            const auto *task = task_;
+            lock.unlock();
+            (*task)(i);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(std::size_t)> *task_ = nullptr;
+    std::size_t next_ = 0;
+    std::size_t count_ = 0;
+    std::size_t pending_ = 0;
+    bool stop_ = false;
+};
+
+struct options {
+    std::string format = "csv";
+    std::size_t column = 0;
+    std::size_t columns = 1;
+    char delimiter = ',';
+    bool header = false;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    const char *output = nullptr;
+    const char *input = nullptr;
+    std::string from;
+    std::string to;
+};
+
+void write_all(std::FILE *out, const char *data, std::size_t n) {
+    if (std::fwrite(data, 1, n, out) != n) {
+        std::perror("units_convert: write");
+        std::exit(1);
+    }
+}
+
+// Binary records of columns values of rep
+template <typename rep>
+void convert_binary(input_file &in, std::FILE *out, const options &opt,
+                    long double factor, thread_pool &pool) {
+    const std::size_t record = sizeof(rep) * opt.columns;
+    const rep f = static_cast<rep>(factor);
+    std::vector<rep> buffer;
+    std::size_t partial = 0;
+
+    while (in.next(partial)) {
+        const std::size_t n = in.size() / record;
+        partial = in.size() - n * record;
+        if (in.at_end() && partial != 0) {
+            std::fprintf(stderr, "units_convert: input is not a whole number of "
+                                 "%zu byte records\n", record);
+            std::exit(1);
+        }
+        buffer.resize(n * opt.columns);
+        const rep *src = reinterpret_cast<const rep*>(in.data());
+        const std::size_t tasks = opt.threads;
+        const std::size_t per_task = (n + tasks - 1) / tasks;
+
+        pool.run(tasks, [&](std::size_t t) {
+            const std::size_t begin = std::min(n, t * per_task);
+            const std::size_t end = std::min(n, begin + per_task);
+            const rep *s = src + begin * opt.columns;
+            rep *d = buffer.data() + begin * opt.columns;
+            if (opt.columns == 1) {
+                units::detail::scale_n(s, end - begin, d, f);
+                return;
+            }
+            std::memcpy(d, s, (end - begin) * record);
+            for (std::size_t r = 0; r < end - begin; ++r) {
+                d[r * opt.columns + opt.column] *= f;
+            }
+        });
+
+        write_all(out, reinterpret_cast<const char*>(buffer.data()), n * record);
+    }
+}
+
+// Convert the CSV lines in [first, last) into out. Returns the offset of the
+// first bad field, or -1.
+std::ptrdiff_t convert_csv_lines(const char *first, const char *last,
+                                 const options &opt, double factor,
+                                 std::string &out) {
+    out.clear();
+    const char *line = first;
+    while (line < last) {
+        const char *eol = static_cast<const char*>(
+            std::memchr(line, '\n', static_cast<std::size_t>(last - line)));
+        if (!eol) {
+            eol = last;
+        }
+
+        // Locate the field to convert
+        const char *field = line;
+        for (std::size_t c = 0; c < opt.column && field < eol; ++c) {
+            const char *d = static_cast<const char*>(std::memchr(
+                field, opt.delimiter, static_cast<std::size_t>(eol - field)));
+            field = d ? d + 1 : eol + 1;
+        }
+        if (field > eol || (field == eol && eol == line)) {
+            // Short or empty line, passed through
+            out.append(line, eol);
+        } else {
+            const char *field_end = static_cast<const char*>(std::memchr(
+                field, opt.delimiter, static_cast<std::size_t>(eol - field)));
+            if (!field_end) {
+                field_end = eol > field && eol[-1] == '\r' ? eol - 1 : eol;
+            }
+            double v;
+            auto r = std::from_chars(field, field_end, v);
+            if (r.ec != std::errc() || r.ptr != field_end) {
+                return field - first;
+            }
+            char num[64];
+            auto w = std::to_chars(num, num + sizeof(num), v * factor);
+            out.append(line, field);
+            out.append(num, w.ptr);
+            out.append(field_end, eol);
+        }
+        if (eol < last) {
+            out.push_back('\n');
+        }
+        line = eol + 1;
+    }
+    return -1;
+}
+
+// Next line start at or after p
+const char* next_line(const char *p, const char *last) {
+    const char *eol = static_cast<const char*>(
+        std::memchr(p, '\n', static_cast<std::size_t>(last - p)));
+    return eol ? eol + 1 : last;
+}
+
+void convert_csv(input_file &in, std::FILE *out, const options &opt,
+                 long double factor, thread_pool &pool) {
+    const std::size_t tasks = opt.threads;
+    std::vector<std::string> buffers(tasks);
+    std::vector<std::ptrdiff_t> errors(tasks);
+    std::vector<const char*> bounds(tasks + 1);
+    bool header = opt.header;
+    std::size_t partial = 0;
+
+    while (in.next(partial)) {
+        const char *p = in.data();
+        const char *last = p + in.size();
+
+        // Convert whole lines, leaving a partial one for the next window
+        const char *window_end = last;
+        if (!in.at_end()) {
+            const std::size_t eol = std::string_view(p, in.size()).rfind('\n');
+            window_end = eol == std::string_view::npos ? p : p + eol + 1;
+        }
+        partial = static_cast<std::size_t>(last - window_end);
+        if (header && window_end > p) {
+            const char *body = next_line(p, window_end);
+            write_all(out, p, static_cast<std::size_t>(body - p));
+            p = body;
+            header = false;
+        }
+
+        // Split the window into chunks of whole lines
+        const std::size_t chunk = static_cast<std::size_t>(window_end - p) / tasks;
+        bounds[0] = p;
+        for (std::size_t t = 1; t < tasks; ++t) {
+            const char *b = std::max(bounds[t - 1], p + t * chunk);
+            bounds[t] = b == p ? p : next_line(b - 1, window_end);
+        }
+        bounds[tasks] = window_end;
+
+        pool.run(tasks, [&](std::size_t t) {
+            errors[t] = convert_csv_lines(bounds[t], bounds[t + 1], opt,
+                                          static_cast<double>(factor),
+                                          buffers[t]);
+        });
+
+        for (std::size_t t = 0; t < tasks; ++t) {
+            if (errors[t] >= 0) {
+                std::fprintf(stderr, "units_convert: invalid number at byte %zu\n",
+                             in.offset() + static_cast<std::size_t>(
+                                 bounds[t] - in.data() + errors[t]));
+                std::exit(1);
+            }
+            write_all(out, buffers[t].data(), buffers[t].size());
+        }
+    }
+}
+
+bool parse_options(int argc, char **argv, options &opt) {
+    std::vector<const char*> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        auto count = [&](std::size_t &n) {
+            const char *v = value();
+            return v && std::from_chars(v, v + std::strlen(v), n).ec == std::errc();
+        };
+        if (arg == "--format") {
+            const char *v = value();
+            if (!v) return false;
+            opt.format = v;
+        } else if (arg == "--column") {
+            if (!count(opt.column)) return false;
+        } else if (arg == "--columns") {
+            if (!count(opt.columns) || opt.columns == 0) return false;
+        } else if (arg == "--delimiter") {
+            const char *v = value();
+            if (!v || std::strlen(v) != 1) return false;
+            opt.delimiter = v[0];
+        } else if (arg == "--header") {
+            opt.header = true;
+        } else if (arg == "--threads") {
+            std::size_t n;
+            if (!count(n) || n == 0) return false;
+            opt.threads = static_cast<unsigned>(n);
+        } else if (arg == "--output") {
+            if (!(opt.output = value())) return false;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            return false;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    if (positional.size() < 2 || positional.size() > 3) {
+        return false;
+    }
+    opt.from = positional[0];
+    opt.to = positional[1];
+    opt.input = positional.size() == 3 ? positional[2] : nullptr;
+    return opt.format == "csv" || opt.format == "f32" || opt.format == "f64";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    options opt;
+    if (!parse_options(argc, argv, opt)) {
+        std::fputs(usage, stderr);
+        return 2;
+    }
+    if (opt.format != "csv" && opt.column >= opt.columns) {
+        std::fprintf(stderr, "units_convert: column %zu out of %zu\n",
+                     opt.column, opt.columns);
+        return 2;
+    }
+
+    long double factor;
+    if (!find_factor(opt.from, opt.to, factor)) {
+        std::fprintf(stderr, "units_convert: cannot convert %s to %s\n",
+                     opt.from.c_str(), opt.to.c_str());
+        return 2;
+    }
+
+    input_file in(opt.input);
+    std::FILE *out = opt.output ? std::fopen(opt.output, "wb") : stdout;
+    if (!out) {
+        std::perror(opt.output);
+        return 1;
+    }
+    std::vector<char> out_buffer(1 << 20);
+    std::setvbuf(out, out_buffer.data(), _IOFBF, out_buffer.size());
+
+    thread_pool pool(opt.threads);
+    if (opt.format == "csv") {
+        convert_csv(in, out, opt, factor, pool);
+    } else if (opt.format == "f32") {
+        convert_binary<float>(in, out, opt, factor, pool);
+    } else {
+        convert_binary<double>(in, out, opt, factor, pool);
+    }
+
+    if (std::fclose(out) != 0) {
+        std::perror("units_convert");
+        return 1;
+    }
+    return 0;
+}